@@ -1,6 +1,8 @@
 TEMPLATE = subdirs
 SUBDIRS = daemon gui \
-    tests
+    tests \
+    benchmark
 daemon.file = daemon.pro
 gui.file = gui.pro
+benchmark.file = benchmark.pro
 
@@ -0,0 +1,13 @@
+# Trace replay benchmark for the daemon job/protocol stack.
+# It builds the daemon sources with a different entry point, see
+# tests/benchmark/main_benchmark.cpp for usage.
+include(daemon.pro)
+
+TARGET = moolticute_benchmark
+
+SOURCES -= src/main_daemon.cpp
+SOURCES += tests/benchmark/main_benchmark.cpp
+
+unix {
+    INSTALLS -= target systemd_user zxcvbn_dict_install
+}
@@ -1,4 +1,4 @@
-QT       += core network websockets widgets
+QT       += core network websockets widgets concurrent
 QT       -= gui
 
 #We need that for qwinoverlappedionotifier class which is private
@@ -13,6 +13,8 @@ CONFIG += c++11
 
 INCLUDEPATH += $$PWD/src $$PWD/src/MessageProtocol $$PWD/src/Mooltipass $$PWD/src/Settings $$PWD/src/CyoEncode
 
+include(src/zxcvbn-c/zxcvbn.pri)
+
 win32 {
     LIBS += -lsetupapi -luser32
 } else:linux {
@@ -61,12 +63,16 @@ SOURCES += src/main_daemon.cpp \
     src/CyoEncode/CyoEncode.c \
     src/MPDevice.cpp \
     src/MPDevice_localSocket.cpp \
+    src/MPDeviceTrace.cpp \
     src/MPManager.cpp \
     src/Common.cpp \
     src/Mooltipass/MPMiniToBleNodeConverter.cpp \
     src/WSServer.cpp \
     src/AppDaemon.cpp \
     src/AsyncJobs.cpp \
+    src/DeviceMetrics.cpp \
+    src/PasswordGenerator.cpp \
+    src/PasswordAudit.cpp \
     src/Mooltipass/MPNode.cpp \
     src/WSServerCon.cpp \
     src/MPDevice_emul.cpp \
@@ -80,6 +86,7 @@ SOURCES += src/main_daemon.cpp \
     src/MessageProtocol/MessageProtocolMini.cpp \
     src/MessageProtocol/MessageProtocolBLE.cpp \
     src/MPDeviceBleImpl.cpp \
+    src/FetchDataWriter.cpp \
     src/HaveIBeenPwned.cpp \
     src/Mooltipass/MPNodeMini.cpp \
     src/Mooltipass/MPNodeBLE.cpp \
@@ -99,6 +106,7 @@ HEADERS  += \
     src/CyoEncode/CyoEncode.hpp \
     src/MPDevice.h \
     src/MPDevice_localSocket.h \
+    src/MPDeviceTrace.h \
     src/MPManager.h \
     src/Mooltipass/MPMiniToBleNodeConverter.h \
     src/MooltipassCmds.h \
@@ -106,6 +114,9 @@ HEADERS  += \
     src/WSServer.h \
     src/AppDaemon.h \
     src/AsyncJobs.h \
+    src/DeviceMetrics.h \
+    src/PasswordGenerator.h \
+    src/PasswordAudit.h \
     src/Mooltipass/MPNode.h \
     src/version.h \
     src/WSServerCon.h \
@@ -120,6 +131,7 @@ HEADERS  += \
     src/MessageProtocol/MessageProtocolMini.h \
     src/MessageProtocol/MessageProtocolBLE.h \
     src/MPDeviceBleImpl.h \
+    src/FetchDataWriter.h \
     src/HaveIBeenPwned.h \
     src/BleCommon.h \
     src/Mooltipass/MPNodeMini.h \
@@ -37,7 +37,6 @@ SOURCES += src/main_gui.cpp \
     src/AnsiEscapeCodeHandler.cpp \
     src/PasswordLineEdit.cpp \
     src/CredentialsManagement.cpp \
-    src/zxcvbn-c/zxcvbn.c \
     src/FilesManagement.cpp \
     src/SSHManagement.cpp \
     src/CredentialView.cpp \
@@ -87,8 +86,6 @@ HEADERS  += src/MainWindow.h \
     src/AnsiEscapeCodeHandler.h \
     src/PasswordLineEdit.h \
     src/CredentialsManagement.h \
-    src/zxcvbn-c/dict-src.h \
-    src/zxcvbn-c/zxcvbn.h \
     src/FilesManagement.h \
     src/SSHManagement.h \
     src/CredentialView.h \
@@ -136,8 +133,9 @@ mac {
         src/SystemNotifications/MacNotify.mm
 }
 
-INCLUDEPATH += src\
-    src/zxcvbn-c
+INCLUDEPATH += src
+
+include(src/zxcvbn-c/zxcvbn.pri)
 
 FORMS    += src/MainWindow.ui \
     src/TOTPCredential.ui \
@@ -27,6 +27,7 @@
 
 bool AppDaemon::emulationMode = false;
 bool AppDaemon::anyAddress = false;
+QString AppDaemon::traceFilePath;
 
 AppDaemon::AppDaemon(int &argc, char **argv):
     QAPP(argc, argv),
@@ -53,6 +54,8 @@ bool AppDaemon::initialize()
     qInfo() << "https://github.com/mooltipass/moolticute";
     qInfo() << "------------------------------------";
 
+    Common::initPasswordDictionary();
+
 #ifdef Q_OS_MAC
     utils::mac::hideDockIcon(true);
 #endif
@@ -114,6 +117,11 @@ bool AppDaemon::initialize()
                                       QCoreApplication::translate("main", "Enable full dev debug log"));
     parser.addOption(debugDevOption);
 
+    QCommandLineOption recordTraceOption(QStringList() << "t" << "record-trace",
+                                         QCoreApplication::translate("main", "Record every packet exchanged with the device, with timing, to a trace file per device connection named after <file>. Traces can be replayed by moolticute_benchmark."),
+                                         QCoreApplication::translate("main", "file"));
+    parser.addOption(recordTraceOption);
+
     parser.process(qApp->arguments());
 
     emulationMode = parser.isSet(emulMode);
@@ -137,6 +145,9 @@ bool AppDaemon::initialize()
     if (parser.isSet(debugDevOption))
         debugDevEnabled = true;
 
+    if (parser.isSet(recordTraceOption))
+        traceFilePath = parser.value(recordTraceOption);
+
     //Install and start mp manager instance and ws server
     if (!WSServer::Instance()->initialize())
     {
@@ -172,6 +183,11 @@ QHostAddress AppDaemon::getListenAddress()
     return QHostAddress::LocalHost;
 }
 
+QString AppDaemon::getTraceFilePath()
+{
+    return traceFilePath;
+}
+
 bool AppDaemon::isDebugDev()
 {
     auto daemon = dynamic_cast<AppDaemon *>(qApp);
@@ -49,6 +49,7 @@ public:
     static QHostAddress getListenAddress();
 
     static bool isDebugDev();
+    static QString getTraceFilePath();
 
 private:
     HttpServer *httpServer = nullptr;
@@ -63,6 +64,7 @@ private:
 
     static bool emulationMode;
     static bool anyAddress;
+    static QString traceFilePath;
 };
 
 #endif // APPDAEMON_H
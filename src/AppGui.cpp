@@ -81,6 +81,7 @@ bool AppGui::initialize()
     qInfo() << "------------------------------------";
 
     setupLanguage();
+    Common::initPasswordDictionary();
 
     QSimpleUpdater::getInstance();
 
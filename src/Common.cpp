@@ -21,6 +21,7 @@
 #include <QLocalSocket>
 #include <time.h>
 #include "version.h"
+#include "zxcvbn.h"
 #include <chrono>
 
 #ifndef Q_OS_WIN
@@ -394,6 +395,47 @@ QString Common::maskLog(const QString &rawJson)
     return logMsg;
 }
 
+bool Common::initPasswordDictionary()
+{
+#ifdef USE_DICT_FILE
+    //A locale specific word list is used first if there is one:
+    //zxcvbn-fr_FR.dict, then zxcvbn-fr.dict, then zxcvbn.dict
+    const QString locale = QLocale::system().name();
+    const QStringList names = { QStringLiteral("zxcvbn-%1.dict").arg(locale),
+                                QStringLiteral("zxcvbn-%1.dict").arg(locale.section('_', 0, 0)),
+                                QStringLiteral("zxcvbn.dict") };
+
+    QStringList dirs = { QCoreApplication::applicationDirPath() };
+#if defined(Q_OS_MAC)
+    dirs << QCoreApplication::applicationDirPath() + "/../Resources";
+#elif defined(MC_INSTALL_PREFIX)
+    dirs << QStringLiteral(MC_INSTALL_PREFIX "/share/moolticute");
+#endif
+
+    for (const QString &dir : dirs)
+    {
+        for (const QString &name : names)
+        {
+            const QString path = QDir(dir).filePath(name);
+            if (!QFile::exists(path))
+                continue;
+
+            if (ZxcvbnInit(QFile::encodeName(path).constData()))
+            {
+                qInfo() << "Password dictionary loaded from" << path;
+                return true;
+            }
+            qWarning() << "Invalid password dictionary:" << path;
+        }
+    }
+
+    qWarning() << "No password dictionary found, strength estimation will not use word lists";
+    return false;
+#else
+    return true;
+#endif
+}
+
 static std::vector<qint64> mpRngIntegers;
 static std::random_device rngDevice;
 
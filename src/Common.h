@@ -239,6 +239,10 @@ public:
     //mask log by removing passwords and data from log
     static QString maskLog(const QString &rawJson);
 
+    //Map the zxcvbn dictionary file when it is not compiled in,
+    //must be called before any password is scored
+    static bool initPasswordDictionary();
+
     static std::vector<qint64> getRngSeed();
     static void updateSeed(std::vector<qint64> &newInts);
 
@@ -174,6 +174,7 @@ void CredentialModel::load(const QJsonArray &json)
 
     beginResetModel();
 
+    clearChanges();
     m_pRootItem->setItemsStatus(TreeItem::UNUSED);
     for (int i=0; i<json.size(); i++)
     {
@@ -331,6 +332,7 @@ void CredentialModel::setTOTP(const QModelIndex &idx, QString secretKey, int tim
     if (pLoginItem != nullptr)
     {
         pLoginItem->setTOTPCredential(secretKey, timeStep, codeSize);
+        markDirty(pLoginItem);
     }
 }
 
@@ -485,13 +487,29 @@ void CredentialModel::updateLoginItem(const QModelIndex &idx, const ItemRole &ro
     default: break;
     }
     if (bChanged)
+    {
+        markDirty(pLoginItem);
         emit dataChanged(idx, idx);
+    }
+}
+
+void CredentialModel::renameService(TreeItem *pServiceItem, const QString &sServiceName)
+{
+    if (pServiceItem == nullptr || pServiceItem->name() == sServiceName)
+        return;
+
+    pServiceItem->setName(sServiceName);
+
+    // The service name is part of every login of the service
+    foreach (TreeItem *pLogin, pServiceItem->childs())
+        markDirty(dynamic_cast<LoginItem *>(pLogin));
 }
 
 void CredentialModel::clear()
 {
     qDebug() << "*** CLEAR ALL ITEMS FROM GUI ***";
     beginResetModel();
+    clearChanges();
     m_pRootItem->clear();
     endResetModel();
 }
@@ -531,6 +549,41 @@ QJsonArray CredentialModel::getJsonChanges()
     return jarr;
 }
 
+/**
+ * Only the logins added or modified since the model was loaded, and the
+ * addresses of the removed ones, for a delta set_credentials request.
+ */
+QJsonObject CredentialModel::getJsonDelta() const
+{
+    QJsonArray jcreds;
+    foreach (LoginItem *pLoginItem, m_dirtyLogins)
+        jcreds.append(pLoginItem->toJson());
+
+    QJsonArray jdeleted;
+    foreach (const QByteArray &bAddress, m_deletedAddresses)
+        jdeleted.append(QJsonArray({(int)bAddress.at(0), (int)bAddress.at(1)}));
+
+    return {{ "credentials", jcreds },
+            { "deleted", jdeleted }};
+}
+
+bool CredentialModel::hasChanges() const
+{
+    return !m_dirtyLogins.isEmpty() || !m_deletedAddresses.isEmpty();
+}
+
+void CredentialModel::markDirty(LoginItem *pLoginItem)
+{
+    if (pLoginItem != nullptr)
+        m_dirtyLogins.insert(pLoginItem);
+}
+
+void CredentialModel::clearChanges()
+{
+    m_dirtyLogins.clear();
+    m_deletedAddresses.clear();
+}
+
 void CredentialModel::addCredential(QString sServiceName, const QString &sLoginName, const QString &sPassword, const QString &sDescription)
 {
     //Force all service names to lowercase
@@ -583,7 +636,10 @@ void CredentialModel::addCredential(QString sServiceName, const QString &sLoginN
     }
 
     if (pAddedLoginItem)
+    {
+        markDirty(pAddedLoginItem);
         emit selectLoginItem(pAddedLoginItem);
+    }
 }
 
 bool CredentialModel::removeCredential(const QModelIndex &idx)
@@ -609,6 +665,11 @@ bool CredentialModel::removeCredential(const QModelIndex &idx)
                 QModelIndex serviceIndex = getServiceIndexByName(pServiceItem->name());
                 if (serviceIndex.isValid())
                 {
+                    // Logins coming from the device are deleted by address
+                    m_dirtyLogins.remove(pLoginItem);
+                    if (pLoginItem->address().size() >= 2)
+                        m_deletedAddresses.append(pLoginItem->address());
+
                     beginRemoveRows(serviceIndex, idx.row(), idx.row());
                     if (pServiceItem->removeOne(pItem))
                         delete pItem;
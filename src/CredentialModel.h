@@ -4,6 +4,7 @@
 // Qt
 #include <QAbstractItemModel>
 #include <QJsonArray>
+#include <QJsonObject>
 #include <QDate>
 #include <QTimer>
 #include <QIcon>
@@ -45,11 +46,14 @@ public:
     void load(const QJsonArray &json);
     void setClearTextPassword(const QString &sServiceName, const QString &sLoginName, const QString &sPassword);
     QJsonArray getJsonChanges();
+    QJsonObject getJsonDelta() const;
+    bool hasChanges() const;
     void addCredential(QString sServiceName, const QString &sLoginName, const QString &sPassword, const QString &sDescription="");
     bool removeCredential(const QModelIndex &idx);
     TreeItem *getItemByIndex(const QModelIndex &idx) const;
     void updateLoginItem(const QModelIndex &idx, const QString &sPassword, const QString &sDescription, const QString &sName, int iCat, int iLoginKey, int iPwdKey);
     void updateLoginItem(const QModelIndex &idx, const ItemRole &role, const QVariant &vValue);
+    void renameService(TreeItem *pServiceItem, const QString &sServiceName);
     void clear();
     QModelIndex getServiceIndexByName(const QString &sServiceName, int column = 0) const;
     LoginItem *getLoginItemByIndex(const QModelIndex &idx) const;
@@ -64,9 +68,14 @@ public:
 private:
     ServiceItem *addService(const QString &sServiceName);
     qint8 getAvailableFavorite(qint8 newFav);
+    void markDirty(LoginItem *pLoginItem);
+    void clearChanges();
 
 private:
     RootItem *m_pRootItem;
+    // Logins added or modified since the last load, and addresses of the removed ones
+    QSet<LoginItem *> m_dirtyLogins;
+    QList<QByteArray> m_deletedAddresses;
     QList<QString> m_categories{tr("Default category"), "", "", "", ""};
     bool m_categoryClean = false;
 
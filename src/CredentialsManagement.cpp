@@ -213,7 +213,6 @@ void CredentialsManagement::setWsClient(WSClient *c)
     connect(wsClient, &WSClient::memoryDataChanged, [=]()
     {
         m_pCredModel->load(wsClient->getMemoryData()["login_nodes"].toArray());
-        m_loadedModelSerialiation = m_pCredModel->getJsonChanges();
         ui->lineEditFilterCred->clear();
     });
     connect(wsClient, &WSClient::passwordUnlocked, this, &CredentialsManagement::onPasswordUnlocked);
@@ -306,8 +305,7 @@ void CredentialsManagement::on_pushButtonEnterMMM_clicked()
 
 void CredentialsManagement::on_buttonDiscard_pressed()
 {
-    auto modelSerialization = m_pCredModel->getJsonChanges();
-    if (modelSerialization == m_loadedModelSerialiation)
+    if (!m_pCredModel->hasChanges())
     {
         wsClient->sendLeaveMMRequest();
         m_pCredModel->clear();
@@ -325,7 +323,7 @@ void CredentialsManagement::on_buttonSaveChanges_clicked()
     saveSelectedCredential();
 
     ui->stackedWidget->setCurrentWidget(ui->pageLocked);
-    wsClient->sendCredentialsMM(m_pCredModel->getJsonChanges());
+    wsClient->sendCredentialsDeltaMM(m_pCredModel->getJsonDelta());
     emit wantSaveMemMode(); //waits for the daemon to process the data
     m_pCredModel->clear();
 }
@@ -468,7 +466,7 @@ void CredentialsManagement::saveCredential(const QModelIndex currentSelectionInd
         ui->credentialTreeView->refreshLoginItem(srcIndex);
         if (pLoginItem->parentItem()->name() != newServiceName)
         {
-            pLoginItem->parentItem()->setName(newServiceName);
+            m_pCredModel->renameService(pLoginItem->parentItem(), newServiceName);
             const QModelIndex serviceIdx = m_pCredModel->getServiceIndexByName(newServiceName);
             //Service name changed, sort to the correct order
             m_pCredModel->dataChanged(serviceIdx, serviceIdx);
@@ -573,7 +571,7 @@ bool CredentialsManagement::confirmDiscardUneditedCredentialChanges(const QModel
 void CredentialsManagement::saveChanges()
 {
     saveSelectedCredential();
-    wsClient->sendCredentialsMM(m_pCredModel->getJsonChanges());
+    wsClient->sendCredentialsDeltaMM(m_pCredModel->getJsonDelta());
     emit wantSaveMemMode();
 }
 
@@ -956,13 +954,7 @@ void CredentialsManagement::enableNonCredentialEditWidgets()
 
 bool CredentialsManagement::isServiceNameExist(const QString &serviceName) const
 {
-    auto found = std::find_if(m_loadedModelSerialiation.begin(), m_loadedModelSerialiation.end(),
-                 [&serviceName] (const QJsonValue &cred)
-                    {
-                        return serviceName == cred.toObject().value("service").toString();
-                    }
-                 );
-    return found != m_loadedModelSerialiation.end();
+    return m_pCredModel->getServiceIndexByName(serviceName).isValid();
 }
 
 void CredentialsManagement::setServiceInputAttributes(const QString &tooltipText, Qt::GlobalColor col)
@@ -124,7 +124,6 @@ private:
     TOTPCredential *m_pTOTPCred = nullptr;
 
     QMenu m_favMenu;
-    QJsonArray m_loadedModelSerialiation;
     bool m_selectionCanceled;
     bool m_isClean = true;
     bool m_isSetCategoryClean = true;
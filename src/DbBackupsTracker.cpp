@@ -10,6 +10,8 @@
 #include <QTimer>
 #include <QApplication>
 #include <QDir>
+#include <QFileInfo>
+#include <QRegularExpression>
 #include <QStandardPaths>
 
 #include "DbBackupChangeNumbersComparator.h"
@@ -19,7 +21,7 @@ DbBackupsTracker::DbBackupsTracker(const QString settingsFilePath, QObject* pare
 {
     loadTracks();
     connect(&watcher, &QFileSystemWatcher::fileChanged,
-            this, &DbBackupsTracker::checkDbBackupSynchronization);
+            this, &DbBackupsTracker::onBackupFileChanged);
 }
 
 DbBackupsTracker::~DbBackupsTracker()
@@ -41,19 +43,6 @@ int DbBackupsTracker::getCredentialsDbChangeNumber() const
     return credentialsDbChangeNumber;
 }
 
-QString DbBackupsTracker::readFile(QString path) const
-{
-    QString content;
-    QFile f(path);
-    if (f.exists())
-    {
-        f.open(QIODevice::ReadOnly);
-        content = f.readAll();
-    }
-    f.close();
-    return content;
-}
-
 int DbBackupsTracker::extractCredentialsDbChangeNumberEncryptedBackup(const QJsonDocument &d) const
 {
     QJsonObject root = d.object();
@@ -73,18 +62,6 @@ int DbBackupsTracker::extractCredentialsDbChangeNumberLegacyBackup(const QJsonDo
     return -1;
 }
 
-int DbBackupsTracker::extractCredentialsDbChangeNumber(const QString &content) const
-{
-    int cn = -1;
-    QJsonDocument d = QJsonDocument::fromJson(content.toLocal8Bit());
-    if (isALegacyBackup(d))
-        cn = extractCredentialsDbChangeNumberLegacyBackup(d);
-    else if (isAnEncryptedBackup(d))
-        cn = extractCredentialsDbChangeNumberEncryptedBackup(d);
-
-    return cn;
-}
-
 int DbBackupsTracker::extractDataDbChangeNumberEncryptedBackup(const QJsonDocument &d) const
 {
     QJsonObject root = d.object();
@@ -114,21 +91,109 @@ int DbBackupsTracker::extractDataDbChangeNumberLegacyBackup(const QJsonDocument
     return -1;
 }
 
-int DbBackupsTracker::extractDataDbChangeNumber(const QString &content) const
+int DbBackupsTracker::tryGetCredentialsDbBackupChangeNumber() const
 {
-    int cn = -1;
-    QJsonDocument d = QJsonDocument::fromJson(content.toLocal8Bit());
-    if (d.isObject())
-        cn = extractDataDbChangeNumberEncryptedBackup(d);
-    else if (d.isArray())
-        cn = extractDataDbChangeNumberLegacyBackup(d);
-    return cn;
+    return tryGetBackupMetadata().credentialsDbChangeNumber;
 }
 
-int DbBackupsTracker::tryGetCredentialsDbBackupChangeNumber() const
+DbBackupsTracker::BackupMetadata DbBackupsTracker::tryGetBackupMetadata() const
+{
+    QString path = getTrackPath(cardId);
+    if (path.isEmpty())
+    {
+        DbBackupsTrackerNoBackupFileSet ex;
+        ex.raise();
+    }
+
+    QFileInfo info(path);
+    if (!info.exists())
+    {
+        metadataCache.remove(path);
+        return BackupMetadata();
+    }
+
+    auto it = metadataCache.constFind(path);
+    if (it != metadataCache.constEnd() &&
+        it->size == info.size() &&
+        it->lastModified == info.lastModified())
+    {
+        return it.value();
+    }
+
+    BackupMetadata metadata = readBackupMetadata(path);
+    metadata.size = info.size();
+    metadata.lastModified = info.lastModified();
+    metadataCache.insert(path, metadata);
+    return metadata;
+}
+
+DbBackupsTracker::BackupMetadata DbBackupsTracker::readBackupMetadata(const QString &path) const
+{
+    BackupMetadata metadata;
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly))
+        return metadata;
+
+    if (scanBackupMetadata(f, metadata))
+        return metadata;
+
+    //Unusual layout, parse the whole file
+    f.seek(0);
+    QJsonDocument d = QJsonDocument::fromJson(f.readAll());
+    if (isALegacyBackup(d))
+    {
+        metadata.credentialsDbChangeNumber = extractCredentialsDbChangeNumberLegacyBackup(d);
+        metadata.dataDbChangeNumber = extractDataDbChangeNumberLegacyBackup(d);
+        metadata.format = "none";
+    }
+    else if (isAnEncryptedBackup(d))
+    {
+        metadata.credentialsDbChangeNumber = extractCredentialsDbChangeNumberEncryptedBackup(d);
+        metadata.dataDbChangeNumber = extractDataDbChangeNumberEncryptedBackup(d);
+        metadata.format = "SimpleCrypt";
+    }
+    return metadata;
+}
+
+bool DbBackupsTracker::scanBackupMetadata(QFile &f, BackupMetadata &metadata) const
 {
-    QString content = tryReadBackupFile();
-    return extractCredentialsDbChangeNumber(content);
+    const QByteArray head = f.read(METADATA_SCAN_SIZE).trimmed();
+    if (head.startsWith('{'))
+    {
+        //Encrypted backups are written with sorted keys, both
+        //change numbers come before the encrypted payload
+        static const QRegularExpression ccnRx("\"credentialsDbChangeNumber\"\\s*:\\s*(-?\\d+)");
+        static const QRegularExpression dcnRx("\"dataDbChangeNumber\"\\s*:\\s*(-?\\d+)");
+        const QString text = QString::fromUtf8(head);
+        const auto ccn = ccnRx.match(text);
+        const auto dcn = dcnRx.match(text);
+        if (!ccn.hasMatch() || !dcn.hasMatch())
+            return false;
+
+        metadata.credentialsDbChangeNumber = ccn.captured(1).toInt();
+        metadata.dataDbChangeNumber = dcn.captured(1).toInt();
+        metadata.format = "SimpleCrypt";
+        return true;
+    }
+    else if (head.startsWith('['))
+    {
+        //Legacy backups end with [..., credentials cn, data cn, number]
+        static const QRegularExpression tailRx(",\\s*(-?\\d+)\\s*,\\s*(-?\\d+)\\s*,\\s*(-?\\d+)\\s*\\]\\s*$");
+        if (f.size() > METADATA_SCAN_SIZE)
+            f.seek(f.size() - METADATA_SCAN_SIZE);
+        else
+            f.seek(0);
+        const auto tail = tailRx.match(QString::fromUtf8(f.read(METADATA_SCAN_SIZE)));
+        if (!tail.hasMatch())
+            return false;
+
+        metadata.credentialsDbChangeNumber = tail.captured(1).toInt();
+        metadata.dataDbChangeNumber = tail.captured(2).toInt();
+        metadata.format = "none";
+        return true;
+    }
+
+    return false;
 }
 
 int DbBackupsTracker::getDataDbChangeNumber() const
@@ -176,22 +241,12 @@ bool DbBackupsTracker::hasBackup() const
 
 QString DbBackupsTracker::getTrackedBackupFileFormat()
 {
-    QString content = tryReadBackupFile();
-    QJsonDocument d = QJsonDocument::fromJson(content.toLocal8Bit());
-
-    if (isALegacyBackup(d))
-        return "none";
-
-    if (isAnEncryptedBackup(d))
-        return "SimpleCrypt";
-
-    return "none";
+    return tryGetBackupMetadata().format;
 }
 
 int DbBackupsTracker::tryGetDataDbBackupChangeNumber() const
 {
-    QString content = tryReadBackupFile();
-    return extractDataDbChangeNumber(content);
+    return tryGetBackupMetadata().dataDbChangeNumber;
 }
 
 void DbBackupsTracker::watchPath(const QString path)
@@ -204,22 +259,6 @@ void DbBackupsTracker::watchPath(const QString path)
     watcher.addPath(path);
 }
 
-QString DbBackupsTracker::tryReadBackupFile() const
-{
-    QString path = getTrackPath(cardId);
-    if (path.isEmpty())
-    {
-        DbBackupsTrackerNoBackupFileSet ex;
-        ex.raise();
-    }
-    else
-    {
-        return readFile(path);
-    }
-
-    return "";
-}
-
 void DbBackupsTracker::track(const QString path)
 {
     if (cardId.isEmpty())
@@ -283,6 +322,13 @@ bool DbBackupsTracker::isDbBackupChangeNumberLower(int backupCCN, int backupDCN)
     return result;
 }
 
+void DbBackupsTracker::onBackupFileChanged(const QString &path)
+{
+    // Size and modification time can stay the same after a quick rewrite
+    metadataCache.remove(path);
+    checkDbBackupSynchronization();
+}
+
 void DbBackupsTracker::checkDbBackupSynchronization()
 {
     try
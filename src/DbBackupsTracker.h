@@ -2,8 +2,11 @@
 #define DBBACKUPSTRACKER_H
 
 #include <QCryptographicHash>
+#include <QDateTime>
 #include <QException>
+#include <QFile>
 #include <QFileSystemWatcher>
+#include <QHash>
 #include <QMap>
 #include <QObject>
 #include <QString>
@@ -76,6 +79,7 @@ public slots:
     void refreshTracking();
 
 protected slots:
+    void onBackupFileChanged(const QString &path);
     void checkDbBackupSynchronization();
 
 private:
@@ -90,14 +94,31 @@ private:
     void loadTracks();
     static QString getSettingsFilePath();
 
+    /**
+     * Change numbers and format of a backup file, cached until
+     * the file size or modification time changes, or the watcher
+     * reports a change
+     */
+    struct BackupMetadata
+    {
+        qint64 size = -1;
+        QDateTime lastModified;
+        int credentialsDbChangeNumber = -1;
+        int dataDbChangeNumber = -1;
+        QString format = "none";
+    };
+    mutable QHash<QString, BackupMetadata> metadataCache;
+
+    /**
+     * throws: DbBackupsTrackerNoBackupFileSet
+     */
+    BackupMetadata tryGetBackupMetadata() const;
+    BackupMetadata readBackupMetadata(const QString &path) const;
+    bool scanBackupMetadata(QFile &f, BackupMetadata &metadata) const;
+
     int tryGetCredentialsDbBackupChangeNumber() const;
     int tryGetDataDbBackupChangeNumber() const;
     void watchPath(const QString path);
-    QString tryReadBackupFile() const;
-    QString readFile(QString path) const;
-
-    int extractCredentialsDbChangeNumber(const QString &content) const;
-    int extractDataDbChangeNumber(const QString &content) const;
 
     bool isALegacyBackup(const QJsonDocument &d) const;
     bool isAnEncryptedBackup(const QJsonDocument &d) const;
@@ -108,6 +129,10 @@ private:
     int extractDataDbChangeNumberLegacyBackup(const QJsonDocument &d) const;
     bool isDbBackupChangeNumberGreater(int backupCCN, int backupDCN) const;
     bool isDbBackupChangeNumberLower(int backupCCN, int backupDCN) const;
+
+    //Change numbers are in the first bytes of encrypted backups
+    //and in the last bytes of legacy backups
+    static constexpr qint64 METADATA_SCAN_SIZE = 4096;
 };
 
 #endif // DBBACKUPSTRACKER_H
@@ -0,0 +1,208 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Moolticute; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "DeviceMetrics.h"
+#include <QJsonArray>
+#include <QMetaEnum>
+#include <functional>
+
+constexpr int DeviceMetrics::BUCKET_COUNT;
+constexpr std::array<int, DeviceMetrics::BUCKET_COUNT> DeviceMetrics::BUCKETS_MS;
+
+void DeviceMetrics::Histogram::add(qint64 value)
+{
+    int i = 0;
+    while (i < BUCKET_COUNT && value > BUCKETS_MS[i])
+    {
+        ++i;
+    }
+    ++buckets[i];
+    ++count;
+    sum += value;
+    max = qMax(max, value);
+}
+
+QJsonObject DeviceMetrics::Histogram::toJson() const
+{
+    QJsonArray arr;
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        QJsonObject bucket;
+        bucket["le"] = i < BUCKETS_MS.size() ? QJsonValue(BUCKETS_MS[i]) : QJsonValue("+Inf");
+        bucket["count"] = static_cast<qint64>(buckets[i]);
+        arr.append(bucket);
+    }
+
+    QJsonObject o;
+    o["count"] = static_cast<qint64>(count);
+    o["sum"] = sum;
+    o["max"] = max;
+    o["buckets"] = arr;
+    return o;
+}
+
+void DeviceMetrics::Histogram::writePrometheus(QByteArray &out, const QByteArray &name, const QByteArray &labels) const
+{
+    //Prometheus buckets are cumulative
+    quint64 cumulated = 0;
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        cumulated += buckets[i];
+        const QByteArray le = i < BUCKETS_MS.size() ? QByteArray::number(BUCKETS_MS[i]) : QByteArray("+Inf");
+        out += name + "_bucket{" + labels + ",le=\"" + le + "\"} " + QByteArray::number(cumulated) + '\n';
+    }
+    out += name + "_sum{" + labels + "} " + QByteArray::number(sum) + '\n';
+    out += name + "_count{" + labels + "} " + QByteArray::number(count) + '\n';
+}
+
+void DeviceMetrics::commandDone(MPCmd::Command cmd, const CommandSample &sample)
+{
+    CommandStats &stats = commands[cmd];
+    stats.packetsOut += static_cast<quint64>(sample.packetsOut);
+    stats.bytesOut += static_cast<quint64>(sample.bytesOut);
+    stats.packetsIn += static_cast<quint64>(sample.packetsIn);
+    stats.bytesIn += static_cast<quint64>(sample.bytesIn);
+    stats.retries += static_cast<quint64>(sample.retries);
+
+    //A timed out command has no meaningful round trip
+    if (sample.timedOut)
+    {
+        ++stats.timeouts;
+    }
+    else
+    {
+        stats.latency.add(sample.latencyMs);
+    }
+}
+
+void DeviceMetrics::jobsDone(const QString &jobsName, qint64 wallMs, bool success)
+{
+    JobsStats &stats = jobs[jobsName];
+    stats.wallTime.add(wallMs);
+    if (!success)
+    {
+        ++stats.failed;
+    }
+}
+
+QJsonObject DeviceMetrics::toJson() const
+{
+    const QMetaEnum m = QMetaEnum::fromType<MPCmd::Command>();
+
+    QJsonObject ocommands;
+    for (auto it = commands.constBegin(); it != commands.constEnd(); ++it)
+    {
+        const CommandStats &stats = it.value();
+        QJsonObject o;
+        o["latency_ms"] = stats.latency.toJson();
+        o["packets_out"] = static_cast<qint64>(stats.packetsOut);
+        o["bytes_out"] = static_cast<qint64>(stats.bytesOut);
+        o["packets_in"] = static_cast<qint64>(stats.packetsIn);
+        o["bytes_in"] = static_cast<qint64>(stats.bytesIn);
+        o["retries"] = static_cast<qint64>(stats.retries);
+        o["timeouts"] = static_cast<qint64>(stats.timeouts);
+        ocommands[m.valueToKey(it.key())] = o;
+    }
+
+    QJsonObject ojobs;
+    for (auto it = jobs.constBegin(); it != jobs.constEnd(); ++it)
+    {
+        QJsonObject o;
+        o["wall_ms"] = it.value().wallTime.toJson();
+        o["failed"] = static_cast<qint64>(it.value().failed);
+        ojobs[it.key()] = o;
+    }
+
+    QJsonObject res;
+    res["commands"] = ocommands;
+    res["jobs"] = ojobs;
+    return res;
+}
+
+QByteArray DeviceMetrics::toPrometheus() const
+{
+    const QMetaEnum m = QMetaEnum::fromType<MPCmd::Command>();
+    QByteArray out;
+
+    out += "# HELP moolticute_command_latency_ms Round trip time of device commands.\n"
+           "# TYPE moolticute_command_latency_ms histogram\n";
+    for (auto it = commands.constBegin(); it != commands.constEnd(); ++it)
+    {
+        it.value().latency.writePrometheus(out, "moolticute_command_latency_ms",
+                                           "command=\"" + QByteArray(m.valueToKey(it.key())) + '"');
+    }
+
+    auto writeCounter = [&out, &m, this](const QByteArray &name, const QByteArray &help,
+                                         std::function<quint64(const CommandStats &)> value)
+    {
+        out += "# HELP " + name + ' ' + help + "\n# TYPE " + name + " counter\n";
+        for (auto it = commands.constBegin(); it != commands.constEnd(); ++it)
+        {
+            out += name + "{command=\"" + m.valueToKey(it.key()) + "\"} " + QByteArray::number(value(it.value())) + '\n';
+        }
+    };
+    writeCounter("moolticute_command_packets_out_total", "Packets written to the device.",
+                 [](const CommandStats &s) { return s.packetsOut; });
+    writeCounter("moolticute_command_bytes_out_total", "Bytes written to the device.",
+                 [](const CommandStats &s) { return s.bytesOut; });
+    writeCounter("moolticute_command_packets_in_total", "Packets read from the device.",
+                 [](const CommandStats &s) { return s.packetsIn; });
+    writeCounter("moolticute_command_bytes_in_total", "Bytes read from the device.",
+                 [](const CommandStats &s) { return s.bytesIn; });
+    writeCounter("moolticute_command_retries_total", "Commands resent after a timeout.",
+                 [](const CommandStats &s) { return s.retries; });
+    writeCounter("moolticute_command_timeouts_total", "Commands that failed after all retries.",
+                 [](const CommandStats &s) { return s.timeouts; });
+
+    out += "# HELP moolticute_jobs_wall_time_ms Wall time of device job queues.\n"
+           "# TYPE moolticute_jobs_wall_time_ms histogram\n";
+    for (auto it = jobs.constBegin(); it != jobs.constEnd(); ++it)
+    {
+        it.value().wallTime.writePrometheus(out, "moolticute_jobs_wall_time_ms",
+                                            "jobs=\"" + escapeLabel(it.key()) + '"');
+    }
+    out += "# HELP moolticute_jobs_failed_total Device job queues that failed.\n"
+           "# TYPE moolticute_jobs_failed_total counter\n";
+    for (auto it = jobs.constBegin(); it != jobs.constEnd(); ++it)
+    {
+        out += "moolticute_jobs_failed_total{jobs=\"" + escapeLabel(it.key()) + "\"} "
+                + QByteArray::number(it.value().failed) + '\n';
+    }
+
+    return out;
+}
+
+void DeviceMetrics::reset()
+{
+    commands.clear();
+    jobs.clear();
+}
+
+QString DeviceMetrics::jobsNameFromLog(const QString &log)
+{
+    return log.section(':', 0, 0).trimmed();
+}
+
+QByteArray DeviceMetrics::escapeLabel(const QString &value)
+{
+    QByteArray res = value.toUtf8();
+    res.replace('\\', "\\\\");
+    res.replace('"', "\\\"");
+    res.replace('\n', "\\n");
+    return res;
+}
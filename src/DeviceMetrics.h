@@ -0,0 +1,107 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Moolticute; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef DEVICEMETRICS_H
+#define DEVICEMETRICS_H
+
+#include <QHash>
+#include <QJsonObject>
+#include <array>
+#include "MooltipassCmds.h"
+
+/**
+ * @brief The DeviceMetrics class
+ * Aggregates per command and per job queue statistics of the
+ * device communication: round trip latency, packets and bytes
+ * exchanged, retries and timeouts, and the wall time of each
+ * AsyncJobs queue.
+ * Available with the "get_metrics" websocket message and on the
+ * /metrics page of the debug http server (Prometheus text format).
+ */
+class DeviceMetrics
+{
+public:
+    static DeviceMetrics *Instance()
+    {
+        static DeviceMetrics inst;
+        return &inst;
+    }
+
+    struct CommandSample
+    {
+        qint64 latencyMs = 0;
+        int packetsOut = 0;
+        int bytesOut = 0;
+        int packetsIn = 0;
+        int bytesIn = 0;
+        int retries = 0;
+        bool timedOut = false;
+    };
+
+    void commandDone(MPCmd::Command cmd, const CommandSample &sample);
+    void jobsDone(const QString &jobsName, qint64 wallMs, bool success);
+
+    QJsonObject toJson() const;
+    QByteArray toPrometheus() const;
+    void reset();
+
+    //Upper bounds in ms of the histogram buckets, the last bucket is +Inf
+    static constexpr int BUCKET_COUNT = 12;
+    static constexpr std::array<int, BUCKET_COUNT> BUCKETS_MS = {{ 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000 }};
+
+    //The log of an AsyncJobs may contain service and login names,
+    //only the generic part before the first ':' is kept
+    static QString jobsNameFromLog(const QString &log);
+
+private:
+    struct Histogram
+    {
+        std::array<quint64, BUCKET_COUNT + 1> buckets = {};
+        quint64 count = 0;
+        qint64 sum = 0;
+        qint64 max = 0;
+
+        void add(qint64 value);
+        QJsonObject toJson() const;
+        void writePrometheus(QByteArray &out, const QByteArray &name, const QByteArray &labels) const;
+    };
+
+    struct CommandStats
+    {
+        Histogram latency;
+        quint64 packetsOut = 0;
+        quint64 bytesOut = 0;
+        quint64 packetsIn = 0;
+        quint64 bytesIn = 0;
+        quint64 retries = 0;
+        quint64 timeouts = 0;
+    };
+
+    struct JobsStats
+    {
+        Histogram wallTime;
+        quint64 failed = 0;
+    };
+
+    static QByteArray escapeLabel(const QString &value);
+
+    QHash<quint16, CommandStats> commands;
+    QHash<QString, JobsStats> jobs;
+};
+
+#endif // DEVICEMETRICS_H
@@ -0,0 +1,96 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Moolticute; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "FetchDataWriter.h"
+
+FetchDataWriter::FetchDataWriter(const QString &filePath, Format format):
+    file(filePath),
+    format(format)
+{
+}
+
+FetchDataWriter::Format FetchDataWriter::formatFromString(const QString &format)
+{
+    return format == "hex" ? Format::HEX : Format::RAW;
+}
+
+void FetchDataWriter::start()
+{
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        emit writeError("Failed to open fetch data file: " + file.fileName());
+        return;
+    }
+
+    buffer.reserve(BUFFER_SIZE);
+    elapsed.start();
+}
+
+void FetchDataWriter::append(const QByteArray &payload)
+{
+    if (!file.isOpen())
+        return;
+
+    if (Format::HEX == format)
+    {
+        buffer.append(payload.toHex());
+        buffer.append('\n');
+    }
+    else
+    {
+        buffer.append(payload);
+    }
+    totalBytes += payload.size();
+
+    if (buffer.size() >= BUFFER_SIZE)
+        flushBuffer();
+
+    if (elapsed.elapsed() - lastReportMs >= THROUGHPUT_REPORT_MS)
+        reportThroughput();
+}
+
+void FetchDataWriter::stop()
+{
+    if (!file.isOpen())
+        return;
+
+    flushBuffer();
+    reportThroughput();
+    file.close();
+}
+
+void FetchDataWriter::flushBuffer()
+{
+    if (buffer.isEmpty())
+        return;
+
+    if (file.write(buffer) != buffer.size())
+        emit writeError("Failed to write fetch data: " + file.errorString());
+    //keeps the reserved capacity
+    buffer.resize(0);
+}
+
+void FetchDataWriter::reportThroughput()
+{
+    const qint64 nowMs = elapsed.elapsed();
+    const qint64 periodMs = qMax<qint64>(1, nowMs - lastReportMs);
+    emit throughputChanged(totalBytes, (totalBytes - lastReportBytes) * 1000 / periodMs);
+
+    lastReportMs = nowMs;
+    lastReportBytes = totalBytes;
+}
@@ -0,0 +1,73 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Moolticute; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef FETCHDATAWRITER_H
+#define FETCHDATAWRITER_H
+
+#include <QObject>
+#include <QFile>
+#include <QElapsedTimer>
+
+/**
+ * @brief The FetchDataWriter class
+ * Writes the payloads of a debug data fetch from a dedicated thread.
+ * Payloads are queued from the device callbacks and gathered in a large
+ * buffer, so the next fetch request does not wait for the disk.
+ * Errors are reported through writeError, the log handler is main thread only.
+ */
+class FetchDataWriter: public QObject
+{
+    Q_OBJECT
+public:
+    enum class Format
+    {
+        RAW,    // payloads appended as received
+        HEX     // one hex encoded payload per line
+    };
+
+    FetchDataWriter(const QString &filePath, Format format);
+
+    static Format formatFromString(const QString &format);
+
+public slots:
+    void start();
+    void append(const QByteArray &payload);
+    void stop();
+
+signals:
+    void throughputChanged(qint64 totalBytes, qint64 bytesPerSec);
+    void writeError(const QString &errstr);
+
+private:
+    void flushBuffer();
+    void reportThroughput();
+
+    QFile file;
+    Format format;
+    QByteArray buffer;
+    QElapsedTimer elapsed;
+
+    qint64 totalBytes = 0;
+    qint64 lastReportBytes = 0;
+    qint64 lastReportMs = 0;
+
+    static constexpr int BUFFER_SIZE = 1024 * 1024;
+    static constexpr int THROUGHPUT_REPORT_MS = 1000;
+};
+
+#endif // FETCHDATAWRITER_H
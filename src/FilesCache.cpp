@@ -5,6 +5,7 @@
 #include <QDir>
 #include <QFile>
 #include <QDebug>
+#include <QSaveFile>
 #include <QTextStream>
 #include <QJsonArray>
 #include <QJsonObject>
@@ -12,9 +13,16 @@
 #include <QStandardPaths>
 #include <QCryptographicHash>
 
-
 FilesCache::FilesCache(QObject *parent) : QObject(parent)
 {
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FLUSH_DELAY_MS);
+    connect(&m_flushTimer, &QTimer::timeout, this, &FilesCache::flush);
+}
+
+FilesCache::~FilesCache()
+{
+    flush();
 }
 
 QByteArray FilesCache::cardCPZ() const
@@ -24,84 +32,160 @@ QByteArray FilesCache::cardCPZ() const
 
 bool FilesCache::save(QList<QVariantMap> files)
 {
-    m_isFileCacheInSync = true;
-    QFile file(m_filePath);
-
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    if (m_filePath.isEmpty())
         return false;
 
-    QJsonObject json;
-    json.insert("db_change_number", static_cast<int>(m_dbChangeNumber));
-
-    QJsonArray filesJson;
-    for (QVariantMap file : files)
-    {
-        QJsonObject fileJson = QJsonDocument::fromVariant(file).object();
-        filesJson.append(fileJson);
-    }
-
-    json.insert("files", filesJson);
-    QJsonDocument doc(json);
+    m_isFileCacheInSync = true;
+    m_flushTimer.stop();
+    m_pendingJournal.clear();
 
-    QTextStream out(&file);
-    out << m_simpleCrypt.encryptToString(doc.toJson());
+    m_files.clear();
+    for (const QVariantMap &file : files)
+        m_files.insert(file.value("name").toString(), file);
+    m_cacheDbChangeNumber = m_dbChangeNumber;
+    m_cacheExists = true;
+    m_loaded = true;
 
-    return true;
+    return compact();
 }
 
 QList<QVariantMap> FilesCache::load()
 {
-    if (!m_dbChangeNumberSet || m_cardCPZ.isEmpty())
+    if (!isReady())
     {
         qDebug() << "dbChangeNumberSet not set or null CPZ";
         return QList<QVariantMap>();
     }
-    else
+
+    ensureLoaded();
+    if (!m_cacheExists)
+        return QList<QVariantMap>();
+
+    if (m_cacheDbChangeNumber != m_dbChangeNumber)
     {
-        QList<QVariantMap> files;
+        qDebug() << "dbChangeNumber miss";
+        m_isFileCacheInSync = false;
+        return QList<QVariantMap>();
+    }
 
-        QFile file(m_filePath);
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-            return files;
+    qDebug() << "dbChangeNumber match";
+    m_isFileCacheInSync = true;
+    return m_files.values();
+}
 
+bool FilesCache::erase()
+{
+    m_flushTimer.stop();
+    m_pendingJournal.clear();
+    m_files.clear();
+    m_cacheDbChangeNumber = std::numeric_limits<quint32>::max();
+    m_cacheExists = false;
+    m_journalEntries = 0;
+    m_needsCompaction = false;
+    m_loaded = isReady();
+
+    if (m_filePath.isEmpty())
+        return false;
 
-        QTextStream in(&file);
-        QString encryptedData = in.readAll();
-        QString rawJSon = m_simpleCrypt.decryptToString(encryptedData);
+    QFile::remove(journalPath());
+    QFile file(m_filePath);
+    return file.remove();
+}
 
-        QJsonObject jsonRoot = QJsonDocument::fromJson(rawJSon.toLocal8Bit()).object();
+bool FilesCache::contains(const QString &name)
+{
+    if (!isReady())
+        return false;
 
-        quint32 cacheDbChangeNumber = jsonRoot.value("db_change_number").toInt();
-        if (cacheDbChangeNumber != m_dbChangeNumber)
-        {
-            qDebug() << "dbChangeNumber miss";
-            m_isFileCacheInSync = false;
-        }
-        else
-        {
-            qDebug() << "dbChangeNumber match";
-            m_isFileCacheInSync = true;
-            QJsonArray filesJson = jsonRoot.value("files").toArray();
-            for (QJsonValue file : filesJson)
-            {
-                QVariant v = file.toVariant();
-                files.append(v.toMap());
-            }
-        }
+    ensureLoaded();
+    return m_cacheDbChangeNumber == m_dbChangeNumber && m_files.contains(name);
+}
 
-        return files;
-    }
+QVariantMap FilesCache::file(const QString &name)
+{
+    if (!isReady())
+        return QVariantMap();
+
+    ensureLoaded();
+    if (m_cacheDbChangeNumber != m_dbChangeNumber)
+        return QVariantMap();
+
+    return m_files.value(name);
 }
 
+bool FilesCache::putFile(const QVariantMap &file)
+{
+    const QString name = file.value("name").toString();
+    if (!isReady() || name.isEmpty())
+        return false;
 
-bool FilesCache::erase()
+    makeCurrent();
+    m_files.insert(name, file);
+
+    QJsonObject entry;
+    entry.insert("put", QJsonObject::fromVariantMap(file));
+    appendJournal(entry);
+    return true;
+}
+
+bool FilesCache::removeFile(const QString &name)
 {
-    QFile file(m_filePath);
-    return file.remove();
+    if (!isReady())
+        return false;
+
+    makeCurrent();
+    if (m_files.remove(name) == 0)
+        return false;
+
+    QJsonObject entry;
+    entry.insert("remove", name);
+    appendJournal(entry);
+    return true;
+}
+
+/**
+ * Write pending operations to disk, appending them to the journal or
+ * rewriting the cache file when the journal got too long.
+ */
+bool FilesCache::flush()
+{
+    m_flushTimer.stop();
+
+    if (!m_loaded || !isReady())
+    {
+        m_pendingJournal.clear();
+        return false;
+    }
+
+    if (m_pendingJournal.isEmpty() && !m_needsCompaction)
+        return true;
+
+    if (m_needsCompaction ||
+        m_journalEntries + m_pendingJournal.size() > JOURNAL_COMPACTION_THRESHOLD)
+    {
+        return compact();
+    }
+
+    QFile journal(journalPath());
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+    {
+        qWarning() << "Failed to open files cache journal, rewriting cache file";
+        return compact();
+    }
+
+    QTextStream out(&journal);
+    for (const QString &line : m_pendingJournal)
+        out << line << '\n';
+    out.flush();
+
+    m_journalEntries += m_pendingJournal.size();
+    m_pendingJournal.clear();
+    return true;
 }
 
 void FilesCache::resetState()
 {
+    unload();
     m_dbChangeNumberSet = false;
     m_cardCPZ = QByteArray();
     m_isFileCacheInSync = true;
@@ -111,10 +195,14 @@ bool FilesCache::setDbChangeNumber(quint32 changeNumber)
 {
     if (m_dbChangeNumberSet && m_dbChangeNumber != changeNumber && !m_cardCPZ.isEmpty())
     {
-        qDebug() << "dbChangeNumber updated, triggering file storage";
-        auto tempDb = load();
+        qDebug() << "dbChangeNumber updated, updating file cache";
+        makeCurrent();
         m_dbChangeNumber = changeNumber;
-        save(tempDb);
+        m_cacheDbChangeNumber = changeNumber;
+
+        QJsonObject entry;
+        entry.insert("db_change_number", static_cast<qint64>(changeNumber));
+        appendJournal(entry);
         return false;
     }
 
@@ -129,8 +217,13 @@ bool FilesCache::setDbChangeNumber(quint32 changeNumber)
 
 bool FilesCache::exist()
 {
-    QFile cache_file(m_filePath);
-    return cache_file.exists();
+    if (m_filePath.isEmpty())
+        return false;
+
+    if (m_loaded)
+        return m_cacheExists;
+
+    return QFile::exists(m_filePath) || QFile::exists(journalPath());
 }
 
 bool FilesCache::isInSync() const
@@ -143,6 +236,7 @@ bool FilesCache::setCardCPZ(QByteArray cardCPZ)
     if (m_cardCPZ == cardCPZ)
         return false;
 
+    unload();
     m_cardCPZ = cardCPZ;
 
     QString fileName = QCryptographicHash::hash(m_cardCPZ, QCryptographicHash::Sha256).toHex().toHex();
@@ -166,3 +260,171 @@ bool FilesCache::setCardCPZ(QByteArray cardCPZ)
     else
         return false;
 }
+
+bool FilesCache::isReady() const
+{
+    return m_dbChangeNumberSet && !m_cardCPZ.isEmpty();
+}
+
+QString FilesCache::journalPath() const
+{
+    return m_filePath + ".journal";
+}
+
+void FilesCache::ensureLoaded()
+{
+    if (m_loaded || !isReady())
+        return;
+
+    m_loaded = true;
+    m_files.clear();
+    m_cacheDbChangeNumber = std::numeric_limits<quint32>::max();
+    m_cacheExists = false;
+    m_journalEntries = 0;
+    m_needsCompaction = false;
+
+    QFile file(m_filePath);
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        m_cacheExists = true;
+
+        QTextStream in(&file);
+        QString encryptedData = in.readAll();
+        QString rawJSon = m_simpleCrypt.decryptToString(encryptedData);
+
+        QJsonObject jsonRoot = QJsonDocument::fromJson(rawJSon.toLocal8Bit()).object();
+        m_cacheDbChangeNumber = jsonRoot.value("db_change_number").toInt();
+
+        QJsonArray filesJson = jsonRoot.value("files").toArray();
+        for (QJsonValue value : filesJson)
+        {
+            QVariantMap item = value.toVariant().toMap();
+            m_files.insert(item.value("name").toString(), item);
+        }
+    }
+
+    // Journal entries are idempotent, replaying a journal that was already
+    // folded into the cache file is harmless
+    QFile journal(journalPath());
+    if (journal.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        QTextStream in(&journal);
+        while (!in.atEnd())
+        {
+            const QString line = in.readLine();
+            if (line.isEmpty())
+                continue;
+
+            QString rawJSon = m_simpleCrypt.decryptToString(line);
+            if (m_simpleCrypt.lastError() != SimpleCrypt::ErrorNoError ||
+                !applyJournalEntry(QJsonDocument::fromJson(rawJSon.toUtf8()).object()))
+            {
+                // Most likely the last line of an interrupted write
+                qWarning() << "Invalid files cache journal entry, dropping the rest of the journal";
+                m_needsCompaction = true;
+                break;
+            }
+
+            m_cacheExists = true;
+            ++m_journalEntries;
+        }
+    }
+}
+
+void FilesCache::unload()
+{
+    flush();
+    m_loaded = false;
+    m_files.clear();
+    m_pendingJournal.clear();
+    m_cacheDbChangeNumber = std::numeric_limits<quint32>::max();
+    m_cacheExists = false;
+    m_journalEntries = 0;
+    m_needsCompaction = false;
+}
+
+/**
+ * Prepare the in memory cache for a change. A cache made for another
+ * db change number is out of date and starts over from an empty list.
+ */
+void FilesCache::makeCurrent()
+{
+    ensureLoaded();
+    if (m_cacheDbChangeNumber != m_dbChangeNumber)
+    {
+        m_files.clear();
+        m_cacheDbChangeNumber = m_dbChangeNumber;
+        m_needsCompaction = true;
+    }
+    m_cacheExists = true;
+    m_isFileCacheInSync = true;
+}
+
+void FilesCache::appendJournal(const QJsonObject &entry)
+{
+    m_pendingJournal.append(m_simpleCrypt.encryptToString(QJsonDocument(entry).toJson(QJsonDocument::Compact)));
+    if (!m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
+bool FilesCache::applyJournalEntry(const QJsonObject &entry)
+{
+    if (entry.contains("put"))
+    {
+        QVariantMap item = entry.value("put").toObject().toVariantMap();
+        const QString name = item.value("name").toString();
+        if (name.isEmpty())
+            return false;
+        m_files.insert(name, item);
+    }
+    else if (entry.contains("remove"))
+    {
+        m_files.remove(entry.value("remove").toString());
+    }
+    else if (entry.contains("db_change_number"))
+    {
+        m_cacheDbChangeNumber = static_cast<quint32>(entry.value("db_change_number").toDouble());
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Rewrite the cache file from memory and drop the journal.
+ */
+bool FilesCache::compact()
+{
+    QSaveFile file(m_filePath);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+
+    QJsonObject json;
+    json.insert("db_change_number", static_cast<int>(m_cacheDbChangeNumber));
+
+    QJsonArray filesJson;
+    for (const QVariantMap &item : m_files)
+    {
+        QJsonObject fileJson = QJsonDocument::fromVariant(item).object();
+        filesJson.append(fileJson);
+    }
+
+    json.insert("files", filesJson);
+    QJsonDocument doc(json);
+
+    QTextStream out(&file);
+    out << m_simpleCrypt.encryptToString(doc.toJson());
+    out.flush();
+
+    if (!file.commit())
+        return false;
+
+    QFile::remove(journalPath());
+    m_pendingJournal.clear();
+    m_journalEntries = 0;
+    m_needsCompaction = false;
+    return true;
+}
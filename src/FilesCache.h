@@ -2,16 +2,31 @@
 #define FILESCACHE_H
 
 #include <QList>
+#include <QMap>
 #include <QVariantHash>
+#include <QJsonObject>
 #include <QObject>
+#include <QStringList>
+#include <QTimer>
 #include "SimpleCrypt/SimpleCrypt.h"
 
+/**
+ * @brief The FilesCache class
+ * Keeps the list of files stored on the current card in memory, sorted by
+ * file name, and persists it in an encrypted file named after the card CPZ.
+ *
+ * Single file operations are not written to the cache file right away:
+ * they are appended to an encrypted journal (one line per operation) a
+ * short time later. The journal is replayed on top of the cache file when
+ * loading, and folded back into it once it grows too long.
+ */
 class FilesCache : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(QByteArray cardCPZ READ cardCPZ WRITE setCardCPZ NOTIFY cardCPZChanged)
 public:
     explicit FilesCache(QObject *parent = nullptr);
+    ~FilesCache();
     QByteArray cardCPZ() const;
 signals:
 
@@ -22,12 +37,27 @@ public slots:
     QList<QVariantMap> load();
     bool erase();
 
+    bool contains(const QString &name);
+    QVariantMap file(const QString &name);
+    bool putFile(const QVariantMap &file);
+    bool removeFile(const QString &name);
+    bool flush();
+
     void resetState();
     bool setCardCPZ(QByteArray cardCPZ);
     bool setDbChangeNumber(quint32 changeNumber);
     bool exist();
     bool isInSync() const;
 private:
+    bool isReady() const;
+    QString journalPath() const;
+    void ensureLoaded();
+    void unload();
+    void makeCurrent();
+    void appendJournal(const QJsonObject &entry);
+    bool applyJournalEntry(const QJsonObject &entry);
+    bool compact();
+
     QByteArray m_cardCPZ;
     QString m_filePath;
     qint64 m_key = 0;
@@ -35,6 +65,21 @@ private:
     quint32 m_dbChangeNumber = std::numeric_limits<quint32>::max();
     SimpleCrypt m_simpleCrypt;
     bool m_isFileCacheInSync = true;
+
+    // In memory copy of the cache file with the journal applied
+    QMap<QString, QVariantMap> m_files;
+    quint32 m_cacheDbChangeNumber = std::numeric_limits<quint32>::max();
+    bool m_loaded = false;
+    bool m_cacheExists = false;
+
+    // Encrypted journal lines waiting to be written
+    QStringList m_pendingJournal;
+    int m_journalEntries = 0;
+    bool m_needsCompaction = false;
+    QTimer m_flushTimer;
+
+    static constexpr int FLUSH_DELAY_MS = 1000;
+    static constexpr int JOURNAL_COMPACTION_THRESHOLD = 64;
 };
 
 #endif // FILESCACHE_H
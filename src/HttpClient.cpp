@@ -18,6 +18,7 @@
  ******************************************************************************/
 #include <QFile>
 #include "HttpClient.h"
+#include "DeviceMetrics.h"
 #include <QDir>
 
 int onMessageBeginCb(http_parser *parser)
@@ -146,6 +147,16 @@ HttpClient::HttpClient(QTcpSocket *socket, QObject *parent) :
         QHash<QString, QString> headers;
         headers["Connection"] = "Close";
 
+        if (m_parseUrl == "/metrics")
+        {
+            headers["Content-Type"] = "text/plain; version=0.0.4";
+            if (m_socket->write(buildHttpResponse(HTTP_200, headers, DeviceMetrics::Instance()->toPrometheus())) == -1)
+                qCritical() << "HttpClient: writing error";
+            socket->flush();
+            CloseConnection();
+            return;
+        }
+
         QFile fp(QString(":/debug/dist%1").arg(QString(m_parseUrl)));
 
         if (fp.exists() && fp.open(QIODevice::ReadOnly))
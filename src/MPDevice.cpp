@@ -26,6 +26,10 @@
 #include "MPSettingsBLE.h"
 #include "MPNodeBLE.h"
 #include "AppDaemon.h"
+#include "DeviceMetrics.h"
+
+#include <QtConcurrent/QtConcurrent>
+#include <QFutureWatcher>
 
 MPDevice::MPDevice(QObject *parent):
     QObject(parent)
@@ -38,17 +42,37 @@ MPDevice::MPDevice(QObject *parent):
     {
         //Do not interfer with any other operation by sending a MOOLTIPASS_STATUS command
         if (commandQueue.size() > 0)
+        {
             return;
+        }
 
         sendData(MPCmd::MOOLTIPASS_STATUS, [this](bool success, const QByteArray &data, bool &)
         {
             if (!success)
                 return;
 
+            const auto prevStatus = get_status();
             processStatusChange(data);
+
+            //Back to the base rate when the status changes, poll less often while it is stable
+            if (get_status() != prevStatus)
+            {
+                resetStatusPolling();
+            }
+            else if (statusTimer->isActive() && statusTimer->interval() < STATUS_MAX_DELAY)
+            {
+                const int nextInterval = statusTimer->interval() * 2;
+                statusTimer->setInterval(nextInterval > STATUS_MAX_DELAY ? static_cast<int>(STATUS_MAX_DELAY) : nextInterval);
+            }
         });
     });
 
+    commandTimer = new QTimer(this);
+    commandTimer->setSingleShot(true);
+    connect(commandTimer, &QTimer::timeout, this, &MPDevice::commandTimerExpired);
+
+    jsonPool.setMaxThreadCount(2);
+
     connect(this, SIGNAL(platformDataRead(QByteArray)), this, SLOT(newDataRead(QByteArray)));
 
 //    connect(this, SIGNAL(platformFailed()), this, SLOT(commandFailed()));
@@ -56,6 +80,8 @@ MPDevice::MPDevice(QObject *parent):
 
 MPDevice::~MPDevice()
 {
+    //Snapshot nodes still use the message protocol
+    jsonPool.waitForDone();
     filesCache.resetState();
     delete pMesProt;
     delete bleImpl;
@@ -77,6 +103,12 @@ void MPDevice::setupMessageProtocol()
         qDebug() << "Mooltipass Mini is connected";
     }
 
+    //Serve the parameters of the last connection while they are read again
+    connect(this, &MPDevice::serialNumberChanged, pSettings, [this](quint32 serialNumber)
+    {
+        pSettings->loadCachedParameters(serialNumber);
+    });
+
     importNodeMap = {
         {EXPORT_SERVICE_NODES_INDEX, &importedLoginNodes},
         {EXPORT_SERVICE_CHILD_NODES_INDEX, &importedLoginChildNodes},
@@ -135,49 +167,6 @@ void MPDevice::sendData(MPCmd::Command c, const QByteArray &data, quint32 timeou
 
     if (!isBLE())
     {
-        cmd.timerTimeout = new QTimer(this);
-        connect(cmd.timerTimeout, &QTimer::timeout, [this]()
-        {
-            auto cmd = pMesProt->getCommand(commandQueue.head().data[0]);
-            commandQueue.head().retry--;
-
-            //Retry is disabled for BLE
-            if (commandQueue.head().retry > 0)
-            {
-                qDebug() << "> Retry command: " << pMesProt->printCmd(cmd);
-                commandQueue.head().sent_ts = QDateTime::currentMSecsSinceEpoch();
-                commandQueue.head().timerTimeout->start(); //restart timer
-                commandQueue.head().retries_done++;
-                for (const auto &data : commandQueue.head().data)
-                {
-                    platformWrite(data);
-                }
-            }
-            else
-            {
-                //Failed after all retry
-                MPCommand currentCmd = commandQueue.head();
-                delete currentCmd.timerTimeout;
-
-                if (isBLE())
-                {
-                    qDebug() << "No response received from the device for: " << pMesProt->printCmd(cmd);
-                }
-                else
-                {
-                    qWarning() << "> Retry command: " << pMesProt->printCmd(cmd) << " has failed too many times. Give up.";
-                }
-
-                bool done = true;
-                currentCmd.cb(false, QByteArray(3, 0x00), done);
-
-                if (done)
-                {
-                    commandQueue.dequeue();
-                    sendDataDequeue();
-                }
-            }
-        });
         if (timeout == CMD_DEFAULT_TIMEOUT)
         {
             timeout = CMD_DEFAULT_TIMEOUT_VAL;
@@ -188,7 +177,7 @@ void MPDevice::sendData(MPCmd::Command c, const QByteArray &data, quint32 timeou
                 timeout += static_cast<quint32>(dynamic_cast<MPSettingsMini*>(pSettings)->get_user_interaction_timeout()) * 1000;
             }
         }
-        cmd.timerTimeout->setInterval(static_cast<int>(timeout));
+        cmd.timeout = static_cast<int>(timeout);
     }
 
     commandQueue.enqueue(cmd);
@@ -212,6 +201,127 @@ void MPDevice::sendData(MPCmd::Command cmd, const QByteArray &data, MPCommandCb
     sendData(cmd, data, CMD_DEFAULT_TIMEOUT, std::move(cb));
 }
 
+void MPDevice::resetStatusPolling()
+{
+    //Only the Mini is polled, BLE devices push their status
+    if (statusTimer->isActive() && statusTimer->interval() != STATUS_STARTING_DELAY)
+    {
+        statusTimer->setInterval(STATUS_STARTING_DELAY);
+    }
+}
+
+void MPDevice::startCommandTimeout()
+{
+    commandResendPending = false;
+    if (commandQueue.isEmpty() || commandQueue.head().timeout <= 0)
+    {
+        commandTimer->stop();
+        return;
+    }
+    commandTimer->start(commandQueue.head().timeout);
+}
+
+void MPDevice::stopCommandTimer()
+{
+    commandResendPending = false;
+    commandTimer->stop();
+}
+
+void MPDevice::recordCommandMetrics(MPCommand &cmd, bool timedOut)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    DeviceMetrics::CommandSample sample;
+    sample.latencyMs = now - cmd.metrics_ts;
+    sample.packetsIn = cmd.packets_in;
+    sample.bytesIn = cmd.bytes_in;
+    sample.timedOut = timedOut;
+
+    //Commands answered more than once only count their packets sent once
+    if (!cmd.metrics_recorded)
+    {
+        sample.retries = cmd.retries_done;
+        sample.packetsOut = cmd.data.size() * (1 + cmd.retries_done);
+        for (const auto &data : cmd.data)
+        {
+            sample.bytesOut += data.size() * (1 + cmd.retries_done);
+        }
+    }
+    DeviceMetrics::Instance()->commandDone(pMesProt->getCommand(cmd.data[0]), sample);
+
+    cmd.metrics_recorded = true;
+    cmd.metrics_ts = now;
+    cmd.packets_in = 0;
+    cmd.bytes_in = 0;
+}
+
+void MPDevice::commandTimerExpired()
+{
+    if (commandQueue.isEmpty())
+    {
+        commandResendPending = false;
+        return;
+    }
+
+    if (commandResendPending)
+    {
+        //Resend requested by the device
+        if (isBLE())
+        {
+            commandResendPending = false;
+            sendDataDequeue();
+        }
+        else
+        {
+            for (const auto &data : commandQueue.head().data)
+            {
+                platformWrite(data);
+            }
+            startCommandTimeout();
+        }
+        return;
+    }
+
+    auto cmd = pMesProt->getCommand(commandQueue.head().data[0]);
+    commandQueue.head().retry--;
+
+    //Retry is disabled for BLE
+    if (commandQueue.head().retry > 0)
+    {
+        qDebug() << "> Retry command: " << pMesProt->printCmd(cmd);
+        commandQueue.head().sent_ts = QDateTime::currentMSecsSinceEpoch();
+        startCommandTimeout();
+        commandQueue.head().retries_done++;
+        for (const auto &data : commandQueue.head().data)
+        {
+            platformWrite(data);
+        }
+    }
+    else
+    {
+        //Failed after all retry
+        recordCommandMetrics(commandQueue.head(), true);
+        MPCommand currentCmd = commandQueue.head();
+
+        if (isBLE())
+        {
+            qDebug() << "No response received from the device for: " << pMesProt->printCmd(cmd);
+        }
+        else
+        {
+            qWarning() << "> Retry command: " << pMesProt->printCmd(cmd) << " has failed too many times. Give up.";
+        }
+
+        bool done = true;
+        currentCmd.cb(false, QByteArray(3, 0x00), done);
+
+        if (done)
+        {
+            commandQueue.dequeue();
+            sendDataDequeue();
+        }
+    }
+}
+
 void MPDevice::enqueueAndRunJob(AsyncJobs *jobs)
 {
     jobsQueue.enqueue(jobs);
@@ -284,11 +394,8 @@ void MPDevice::newDataRead(const QByteArray &data)
         dataCommand == MPCmd::MOOLTIPASS_STATUS &&
         (pMesProt->getFirstPayloadByte(data) & MP_UNLOCKING_SCREEN_BITMASK) != 0))
     {
-        if (!isBLE())
-        {
-            /* Stop timeout timer */
-            commandQueue.head().timerTimeout->stop();
-        }
+        /* Stop timeout timer */
+        stopCommandTimer();
 
         /* Bear with me for this complex explanation.
          * In some case, USB commands may take quite a while to get an answer, especially when the user is prompted (or is deliberately trying to delay the answer)
@@ -308,25 +415,8 @@ void MPDevice::newDataRead(const QByteArray &data)
         else
         {
             qDebug() << pMesProt->printCmd(dataCommand) << " received, resending command " << pMesProt->printCmd(currentCommand);
-            QTimer *timer = new QTimer(this);
-            connect(timer, &QTimer::timeout, [this, timer]()
-            {
-                timer->stop();
-                timer->deleteLater();
-                if (isBLE())
-                {
-                    sendDataDequeue();
-                }
-                else
-                {
-                    for (const auto &data : commandQueue.head().data)
-                    {
-                        platformWrite(data);
-                    }
-                    commandQueue.head().timerTimeout->start(); //restart timer
-                }
-            });
-            timer->start(300);
+            commandResendPending = true;
+            commandTimer->start(300);
         }
         return;
     }
@@ -373,6 +463,9 @@ void MPDevice::newDataRead(const QByteArray &data)
       * response QByteArray for backward compatibility reasons
       * with Mini and Classic.
       */
+    commandQueue.head().packets_in++;
+    commandQueue.head().bytes_in += data.size();
+
     if (isBLE())
     {
         if (!bleImpl->processReceivedData(data, dataReceived))
@@ -383,12 +476,9 @@ void MPDevice::newDataRead(const QByteArray &data)
     }
 
     bool done = true;
+    stopCommandTimer();
+    recordCommandMetrics(commandQueue.head(), false);
     currentCmd.cb(true, dataReceived, done);
-    delete currentCmd.timerTimeout;
-    if (!commandQueue.empty())
-    {
-        commandQueue.head().timerTimeout = nullptr;
-    }
 
     if (done)
     {
@@ -424,6 +514,11 @@ void MPDevice::sendDataDequeue()
     if (AppDaemon::isDebugDev())
         qDebug() << "Platform send command: " << pMesProt->printCmd(currentCmd.data[0]);
 
+    if (currentCmd.metrics_ts == 0)
+    {
+        currentCmd.metrics_ts = QDateTime::currentMSecsSinceEpoch();
+    }
+
     if (isBLE())
     {
         bleImpl->flipMessageBit(currentCmd.data);
@@ -463,7 +558,7 @@ void MPDevice::sendDataDequeue()
     }
     else
     {
-        currentCmd.timerTimeout->start();
+        startCommandTimeout();
     }
 }
 
@@ -474,13 +569,17 @@ void MPDevice::runAndDequeueJobs()
 
     currentJobs = jobsQueue.dequeue();
 
-    connect(currentJobs, &AsyncJobs::finished, [this](const QByteArray &)
+    const QString jobsName = DeviceMetrics::jobsNameFromLog(currentJobs->getLog());
+    const qint64 startTs = QDateTime::currentMSecsSinceEpoch();
+    connect(currentJobs, &AsyncJobs::finished, [this, jobsName, startTs](const QByteArray &)
     {
+        DeviceMetrics::Instance()->jobsDone(jobsName, QDateTime::currentMSecsSinceEpoch() - startTs, true);
         currentJobs = nullptr;
         runAndDequeueJobs();
     });
-    connect(currentJobs, &AsyncJobs::failed, [this](AsyncJob *)
+    connect(currentJobs, &AsyncJobs::failed, [this, jobsName, startTs](AsyncJob *)
     {
+        DeviceMetrics::Instance()->jobsDone(jobsName, QDateTime::currentMSecsSinceEpoch() - startTs, false);
         currentJobs = nullptr;
         runAndDequeueJobs();
     });
@@ -517,72 +616,37 @@ void MPDevice::updateFilesCache()
 
 void MPDevice::addFileToCache(QString fileName, int size)
 {
+    if (filesCache.contains(fileName))
+    {
+        // the file is already in cache, this is just and update
+        return;
+    }
+
     QVariantMap item;
     item.insert("name", fileName);
     item.insert("size", size);
 
-    // Add file name at proper position
-    auto cache = filesCache.load();
-    for (qint32 i = 0; i < cache.length(); i++)
-    {
-        if (cache[i].value("name").toString().compare(fileName) == 0)
-        {
-            // the file is already in cache, this is just and update
-            return;
-        }
-
-
-        if (cache[i].value("name").toString().compare(fileName) > 0)
-        {
-            cache.insert(i, item);
-            filesCache.save(cache);
-            emit filesCacheChanged();
-            return;
-        }
-    }
-
-    cache.append(item);
-    filesCache.save(cache);
+    filesCache.putFile(item);
     emit filesCacheChanged();
 }
 
 void MPDevice::updateFileInCache(QString fileName, int size)
 {
-    auto cache = filesCache.load();
-    bool updated = false;
-    for (int i = 0; i < cache.length() && !updated; i ++)
-    {
-        auto item = cache.at(i);
-        if (item.value("name").toString().compare(fileName) == 0)
-        {
-            int revision = item.value("revision").toInt();
-            item.insert("revision", revision  + 1);
-            item.insert("size", size);
+    auto item = filesCache.file(fileName);
+    if (item.isEmpty())
+        return;
 
-            cache.replace(i, item);
-            updated = true;
-        }
-    }
+    int revision = item.value("revision").toInt();
+    item.insert("revision", revision  + 1);
+    item.insert("size", size);
 
-    if (updated)
-    {
-        filesCache.save(cache);
-        emit filesCacheChanged();
-    }
+    filesCache.putFile(item);
+    emit filesCacheChanged();
 }
 
 void MPDevice::removeFileFromCache(QString fileName)
 {
-    auto cache = filesCache.load();
-    int i = 0;
-    for (; i < cache.length(); i++)
-        if (cache.at(i).value("name").toString().compare(fileName) == 0)
-            break;
-
-    if (i < cache.length())
-        cache.removeAt(i);
-
-    filesCache.save(cache);
+    filesCache.removeFile(fileName);
     emit filesCacheChanged();
 }
 
@@ -599,6 +663,7 @@ void MPDevice::resetCommunication()
     jobsQueue.clear();
     currentJobs = nullptr;
     commandQueue.clear();
+    stopCommandTimer();
 }
 
 void MPDevice::memMgmtModeReadFlash(AsyncJobs *jobs, bool fullScan,
@@ -1074,7 +1139,6 @@ void MPDevice::loadSingleNodeAndScan(AsyncJobs *jobs, const QByteArray &address,
             /* Append received data to node data */
             const auto payload = pMesProt->getFullPayload(data);
             pnode->appendData(payload);
-            pnodeClone->appendData(payload);
 
             // Continue to read data until the node is fully received
             if (!pnode->isDataLengthValid())
@@ -1083,6 +1147,9 @@ void MPDevice::loadSingleNodeAndScan(AsyncJobs *jobs, const QByteArray &address,
             }
             else
             {
+                // Clone keeps the loaded data, MMM changes to the node are journaled
+                pnodeClone->shareData(*pnode);
+                nodeChangeJournal.attach(pnode);
                 diagTotalBlocks++;
 
                 // Node is loaded
@@ -1175,7 +1242,6 @@ void MPDevice::loadLoginNode(AsyncJobs *jobs, const QByteArray &address, const M
             /* Append received data to node data */
             const auto payload = pMesProt->getFullPayload(data);
             pnode->appendData(payload);
-            pnodeClone->appendData(payload);
             QString srv = pnode->getService();
 
             //Continue to read data until the node is fully received
@@ -1185,6 +1251,9 @@ void MPDevice::loadLoginNode(AsyncJobs *jobs, const QByteArray &address, const M
             }
             else
             {
+                // Clone keeps the loaded data, MMM changes to the node are journaled
+                pnodeClone->shareData(*pnode);
+                nodeChangeJournal.attach(pnode);
                 if (srv.size() > 0)
                 {
                     double currentFirstCharVal = srv.at(0).toLower().toLatin1();
@@ -1265,7 +1334,6 @@ void MPDevice::loadLoginChildNode(AsyncJobs *jobs, MPNode *parent, MPNode *paren
             /* Append received data to node data */
             const auto payload = pMesProt->getFullPayload(data);
             cnode->appendData(payload);
-            cnodeClone->appendData(payload);
 
             //Continue to read data until the node is fully received
             if (!cnode->isDataLengthValid())
@@ -1274,6 +1342,9 @@ void MPDevice::loadLoginChildNode(AsyncJobs *jobs, MPNode *parent, MPNode *paren
             }
             else
             {
+                // Clone keeps the loaded data, MMM changes to the node are journaled
+                cnodeClone->shareData(*cnode);
+                nodeChangeJournal.attach(cnode);
                 //Node is loaded
                 qDebug() << address.toHex() << ": child node loaded:" << cnode->getLogin();
 
@@ -1312,7 +1383,6 @@ void MPDevice::loadDataNode(AsyncJobs *jobs, const QByteArray &address, bool loa
 
         const auto payload = pMesProt->getFullPayload(data);
         pnode->appendData(payload);
-        pnodeClone->appendData(payload);
 
         //Continue to read data until the node is fully received
         if (!pnode->isValid())
@@ -1321,6 +1391,9 @@ void MPDevice::loadDataNode(AsyncJobs *jobs, const QByteArray &address, bool loa
         }
         else
         {
+            // Clone keeps the loaded data, MMM changes to the node are journaled
+            pnodeClone->shareData(*pnode);
+            nodeChangeJournal.attach(pnode);
             QVariantMap data = {
                 {"total", -1},
                 {"current", 0},
@@ -1382,7 +1455,6 @@ void MPDevice::loadDataChildNode(AsyncJobs *jobs, MPNode *parent, MPNode *parent
 
         const auto payload = pMesProt->getFullPayload(data);
         cnode->appendData(payload);
-        cnodeClone->appendData(payload);
 
         //Continue to read data until the node is fully received
         if (!cnode->isValid())
@@ -1391,6 +1463,9 @@ void MPDevice::loadDataChildNode(AsyncJobs *jobs, MPNode *parent, MPNode *parent
         }
         else
         {
+            // Clone keeps the loaded data, MMM changes to the node are journaled
+            cnodeClone->shareData(*cnode);
+            nodeChangeJournal.attach(cnode);
             //Node is loaded
             qDebug() << "Child data node loaded";
             const auto dataEncSize = pMesProt->getDataNodeEncSize();
@@ -1509,6 +1584,64 @@ MPNode *MPDevice::findNodeWithAddressInList(NodeList list, const QByteArray &add
     return it == list.end()?nullptr:*it;
 }
 
+MPDevice::NodeAddressIndex MPDevice::indexNodesByAddress(const NodeList &list)
+{
+    NodeAddressIndex index;
+    index.nodes.reserve(list.size());
+    for (MPNode *node : list)
+    {
+        index.insert(node);
+    }
+    return index;
+}
+
+MPNode *MPDevice::NodeAddressIndex::find(const QByteArray &address, const quint32 virt_addr) const
+{
+    MPNode::Link link = MPNode::Link::fromAddress(address, virt_addr);
+    link.virtualAddress = virt_addr;
+    return find(link);
+}
+
+MPNode *MPDevice::NodeAddressIndex::find(const MPNode::Link &link) const
+{
+    // A real address missing from the index falls back to the virtual one, like a linear search would
+    MPNode *node = link.isVirtual ? nullptr : nodes.value(link.address);
+    return node ? node : virtualNodes.value(link.virtualAddress);
+}
+
+void MPDevice::NodeAddressIndex::insert(MPNode *node)
+{
+    // Keep the first node of the list for an address, like a linear search would
+    const MPNode::Link link = node->getAddressLink();
+    if (link.isVirtual)
+    {
+        if (!virtualNodes.contains(link.virtualAddress))
+        {
+            virtualNodes.insert(link.virtualAddress, node);
+        }
+    }
+    else if (!nodes.contains(link.address))
+    {
+        nodes.insert(link.address, node);
+    }
+}
+
+void MPDevice::NodeAddressIndex::remove(MPNode *node)
+{
+    const MPNode::Link link = node->getAddressLink();
+    if (link.isVirtual)
+    {
+        if (virtualNodes.value(link.virtualAddress) == node)
+        {
+            virtualNodes.remove(link.virtualAddress);
+        }
+    }
+    else if (nodes.value(link.address) == node)
+    {
+        nodes.remove(link.address);
+    }
+}
+
 /* Find a node inside a given list given his address */
 MPNode *MPDevice::findNodeWithNameInList(NodeList list, const QString& name, bool isParent)
 {
@@ -1740,10 +1873,8 @@ void MPDevice::detagPointedNodes(Common::AddressType addrType /*= Common::CRED_A
 /* Follow the chain to tag pointed nodes (useful when doing integrity check when we are getting everything we can) */
 bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAllowed, Common::AddressType addrType /*= Common::CRED_ADDR_IDX*/)
 {
-    quint32 tempVirtualParentAddress;
-    QByteArray tempParentAddress;
-    quint32 tempVirtualChildAddress;
-    QByteArray tempChildAddress;
+    MPNode::Link tempParentLink;
+    MPNode::Link tempChildLink;
     MPNode* tempNextParentNodePt = nullptr;
     MPNode* tempParentNodePt = nullptr;
     MPNode* tempNextChildNodePt = nullptr;
@@ -1758,24 +1889,28 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
 
     if (tagCredentials)
     {
+        /* Links are resolved through address lookup tables, the chains are not modified here */
+        const NodeAddressIndex parentIndex = indexNodesByAddress(nodes);
+        const NodeAddressIndex childIndex = indexNodesByAddress(childNodes);
+
         /* start with start node (duh) */
-        tempParentAddress = startNode[addrType];
-        tempVirtualParentAddress = virtualStartNode[addrType];
+        const MPNode::Link startLink = MPNode::Link::fromAddress(startNode[addrType], virtualStartNode[addrType]);
+        tempParentLink = startLink;
 
         /* Loop through the parent nodes */
-        while ((tempParentAddress != MPNode::EmptyAddress) || (tempParentAddress.isNull() && tempVirtualParentAddress != 0))
+        while (!tempParentLink.isEmpty())
         {
             /* Get pointer to next parent node */
-            tempNextParentNodePt = findNodeWithAddressInList(nodes, tempParentAddress, tempVirtualParentAddress);
+            tempNextParentNodePt = parentIndex.find(tempParentLink);
 
             /* Check that we could actually find it */
             if (!tempNextParentNodePt)
             {
-                qCritical() << "tagPointedNodes: couldn't find parent node with address" << tempParentAddress.toHex() << "in our list";
+                qCritical() << "tagPointedNodes: couldn't find parent node with address" << tempParentLink.toAddress().toHex() << "in our list";
 
                 if (repairAllowed)
                 {
-                    if ((!tempParentAddress.isNull() && tempParentAddress == startNode[addrType]) || (tempParentAddress.isNull() && tempVirtualParentAddress == virtualStartNode[addrType]))
+                    if (tempParentLink == startLink)
                     {
                         /* start node is incorrect */
                         startNode[addrType] = QByteArray(MPNode::EmptyAddress);
@@ -1795,11 +1930,11 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
             else if (tempNextParentNodePt->getPointedToCheck())
             {
                 /* Linked chain loop detected */
-                qCritical() << "tagPointedNodes: parent node loop has been detected: parent node with address" << tempParentNodePt->getAddress().toHex() << " points to parent node with address" << tempParentAddress.toHex();
+                qCritical() << "tagPointedNodes: parent node loop has been detected: parent node with address" << tempParentNodePt->getAddress().toHex() << " points to parent node with address" << tempParentLink.toAddress().toHex();
 
                 if (repairAllowed)
                 {
-                    if ((!tempParentAddress.isNull() && tempParentAddress == startNode[addrType]) || (tempParentAddress.isNull() && tempVirtualParentAddress == virtualStartNode[addrType]))
+                    if (tempParentLink == startLink)
                     {
                         /* start node is already tagged... how's that possible? */
                         startNode[addrType] = QByteArray(MPNode::EmptyAddress);
@@ -1819,12 +1954,13 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
             else
             {
                 /* check previous node address */
-                if ((!tempParentAddress.isNull() && tempParentAddress == startNode[addrType]) || (tempParentAddress.isNull() && tempVirtualParentAddress == virtualStartNode[addrType]))
+                const MPNode::Link prevParentLink = tempNextParentNodePt->getPreviousParentLink();
+                if (tempParentLink == startLink)
                 {
                     /* first parent node: previous address should be an empty one */
-                    if ((tempNextParentNodePt->getPreviousParentAddress() != MPNode::EmptyAddress) || (tempNextParentNodePt->getPreviousParentAddress().isNull() && tempNextParentNodePt->getPreviousParentVirtualAddress() != 0))
+                    if (!prevParentLink.isEmpty())
                     {
-                        qWarning() << "tagPointedNodes: parent node" << tempNextParentNodePt->getService() <<  "at address" << tempParentAddress.toHex() << "has incorrect previous address:" << tempNextParentNodePt->getPreviousParentAddress().toHex() << "instead of" << MPNode::EmptyAddress.toHex();
+                        qWarning() << "tagPointedNodes: parent node" << tempNextParentNodePt->getService() <<  "at address" << tempParentLink.toAddress().toHex() << "has incorrect previous address:" << prevParentLink.toAddress().toHex() << "instead of" << MPNode::EmptyAddress.toHex();
                         if (repairAllowed)
                         {
                             tempNextParentNodePt->setPreviousParentAddress(MPNode::EmptyAddress);
@@ -1835,9 +1971,9 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
                 else
                 {
                     /* normal linked chain */
-                    if ((!tempNextParentNodePt->getPreviousParentAddress().isNull() && tempNextParentNodePt->getPreviousParentAddress() != tempParentNodePt->getAddress()) || (tempNextParentNodePt->getPreviousParentAddress().isNull() && tempNextParentNodePt->getPreviousParentVirtualAddress() != tempParentNodePt->getVirtualAddress()))
+                    if (prevParentLink != tempParentNodePt->getAddressLink())
                     {
-                        qWarning() << "tagPointedNodes: parent node" << tempNextParentNodePt->getService() <<  "at address" << tempParentAddress.toHex() << "has incorrect previous address:" << tempNextParentNodePt->getPreviousParentAddress().toHex() << "instead of" << tempParentNodePt->getAddress().toHex();
+                        qWarning() << "tagPointedNodes: parent node" << tempNextParentNodePt->getService() <<  "at address" << tempParentLink.toAddress().toHex() << "has incorrect previous address:" << prevParentLink.toAddress().toHex() << "instead of" << tempParentNodePt->getAddress().toHex();
                         if (repairAllowed)
                         {
                             tempNextParentNodePt->setPreviousParentAddress(tempParentNodePt->getAddress(), tempParentNodePt->getVirtualAddress());
@@ -1853,24 +1989,24 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
                 tempParentNodePt->setPointedToCheck();
 
                 /* get first child */
-                tempChildAddress = tempParentNodePt->getStartChildAddress();
-                tempVirtualChildAddress = tempParentNodePt->getStartChildVirtualAddress();
+                const MPNode::Link startChildLink = tempParentNodePt->getStartChildLink();
+                tempChildLink = startChildLink;
 
                 /* browse through all the children */
-                while ((tempChildAddress != MPNode::EmptyAddress) || (tempChildAddress.isNull() && tempVirtualChildAddress != 0))
+                while (!tempChildLink.isEmpty())
                 {
                     /* Get pointer to the child node */
-                    tempNextChildNodePt = findNodeWithAddressInList(childNodes, tempChildAddress, tempVirtualChildAddress);
+                    tempNextChildNodePt = childIndex.find(tempChildLink);
 
                     /* Check we could find child pointer */
                     if (!tempNextChildNodePt)
                     {
-                        qWarning() << "tagPointedNodes: couldn't find child node with address" << tempChildAddress.toHex() << "in our list";
+                        qWarning() << "tagPointedNodes: couldn't find child node with address" << tempChildLink.toAddress().toHex() << "in our list";
                         return_bool = false;
 
                         if (repairAllowed)
                         {
-                            if ((!tempChildAddress.isNull() && tempChildAddress == tempParentNodePt->getStartChildAddress()) || (tempChildAddress.isNull() && tempVirtualChildAddress == tempParentNodePt->getStartChildVirtualAddress()))
+                            if (tempChildLink == startChildLink)
                             {
                                 // first child
                                 tempParentNodePt->setStartChildAddress(MPNode::EmptyAddress);
@@ -1883,14 +2019,14 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
                         }
 
                         /* Loop to next parent */
-                        tempChildAddress = MPNode::EmptyAddress;
+                        tempChildLink = MPNode::Link{};
                     }
                     else if (tempNextChildNodePt->getPointedToCheck())
                     {
                         /* Linked chain loop detected */
-                        if ((!tempChildAddress.isNull() && tempChildAddress == tempParentNodePt->getStartChildAddress()) || (tempChildAddress.isNull() && tempVirtualChildAddress == tempParentNodePt->getStartChildVirtualAddress()))
+                        if (tempChildLink == startChildLink)
                         {
-                            qCritical() << "tagPointedNodes: child node already pointed to: parent node with address" << tempParentAddress.toHex() << " points to child node with address" << tempChildAddress.toHex();
+                            qCritical() << "tagPointedNodes: child node already pointed to: parent node with address" << tempParentLink.toAddress().toHex() << " points to child node with address" << tempChildLink.toAddress().toHex();
                             if (repairAllowed)
                             {
                                 tempParentNodePt->setStartChildAddress(MPNode::EmptyAddress);
@@ -1898,7 +2034,7 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
                         }
                         else
                         {
-                            qCritical() << "tagPointedNodes: child node loop has been detected: child node with address" << tempChildNodePt->getAddress().toHex() << " points to child node with address" << tempChildAddress.toHex();
+                            qCritical() << "tagPointedNodes: child node loop has been detected: child node with address" << tempChildNodePt->getAddress().toHex() << " points to child node with address" << tempChildLink.toAddress().toHex();
                             if (repairAllowed)
                             {
                                 tempChildNodePt->setNextChildAddress(MPNode::EmptyAddress);
@@ -1912,12 +2048,13 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
                     else
                     {
                         /* check previous node address */
-                        if ((!tempChildAddress.isNull() && tempChildAddress == tempParentNodePt->getStartChildAddress()) || (tempChildAddress.isNull() && tempVirtualChildAddress == tempParentNodePt->getStartChildVirtualAddress()))
+                        const MPNode::Link prevChildLink = tempNextChildNodePt->getPreviousChildLink();
+                        if (tempChildLink == startChildLink)
                         {
-                            /* first child node in given parent: previous address should be an empty one */
-                            if ((!tempNextChildNodePt->getPreviousChildAddress().isNull() && tempNextChildNodePt->getPreviousChildAddress() != MPNode::EmptyAddress) || (tempNextChildNodePt->getPreviousChildAddress().isNull() && tempNextChildNodePt->getPreviousChildVirtualAddress() != 0))
+                            /* first child node in given parent: previous address should be an empty one (virtual 0 is accepted) */
+                            if (!prevChildLink.isEmpty() && !(prevChildLink.isVirtual && 0 == prevChildLink.virtualAddress))
                             {
-                                qWarning() << "tagPointedNodes: child node" << tempNextChildNodePt->getLogin() <<  "at address" << tempChildAddress.toHex() << "has incorrect previous address:" << tempNextChildNodePt->getPreviousChildAddress().toHex() << "instead of" << MPNode::EmptyAddress.toHex();
+                                qWarning() << "tagPointedNodes: child node" << tempNextChildNodePt->getLogin() <<  "at address" << tempChildLink.toAddress().toHex() << "has incorrect previous address:" << prevChildLink.toAddress().toHex() << "instead of" << MPNode::EmptyAddress.toHex();
                                 if (repairAllowed)
                                 {
                                     tempNextChildNodePt->setPreviousChildAddress(MPNode::EmptyAddress);
@@ -1928,9 +2065,9 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
                         else
                         {
                             /* normal linked chain */
-                            if ((!tempNextChildNodePt->getPreviousChildAddress().isNull() && tempNextChildNodePt->getPreviousChildAddress() != tempChildNodePt->getAddress()) || (tempNextChildNodePt->getPreviousChildAddress().isNull() && tempNextChildNodePt->getPreviousChildVirtualAddress() != tempChildNodePt->getVirtualAddress()))
+                            if (prevChildLink != tempChildNodePt->getAddressLink())
                             {
-                                qWarning() << "tagPointedNodes: child node" << tempNextChildNodePt->getLogin() <<  "at address" << tempChildAddress.toHex() << "has incorrect previous address:" << tempNextChildNodePt->getPreviousChildAddress().toHex() << "instead of" << tempChildNodePt->getAddress().toHex();
+                                qWarning() << "tagPointedNodes: child node" << tempNextChildNodePt->getLogin() <<  "at address" << tempChildLink.toAddress().toHex() << "has incorrect previous address:" << prevChildLink.toAddress().toHex() << "instead of" << tempChildNodePt->getAddress().toHex();
                                 if (repairAllowed)
                                 {
                                     tempNextChildNodePt->setPreviousChildAddress(tempChildNodePt->getAddress());
@@ -1946,14 +2083,12 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
                         tempChildNodePt->setPointedToCheck();
 
                         /* Loop to next possible child */
-                        tempChildAddress = tempChildNodePt->getNextChildAddress();
-                        tempVirtualChildAddress = tempChildNodePt->getNextChildVirtualAddress();
+                        tempChildLink = tempChildNodePt->getNextChildLink();
                     }
                 }
 
                 /* get next parent address */
-                tempParentAddress = tempParentNodePt->getNextParentAddress();
-                tempVirtualParentAddress = tempParentNodePt->getNextParentVirtualAddress();
+                tempParentLink = tempParentNodePt->getNextParentLink();
             }
         }
     }
@@ -1961,24 +2096,27 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
     if (tagData && isCred)
     {
         /** SAME FOR DATA NODES **/
+        const NodeAddressIndex parentIndex = indexNodesByAddress(dataNodes);
+        const NodeAddressIndex childIndex = indexNodesByAddress(dataChildNodes);
+
         /* start with start node (duh) */
-        tempParentAddress = startDataNode;
-        tempVirtualParentAddress = virtualDataStartNode;
+        const MPNode::Link startLink = MPNode::Link::fromAddress(startDataNode, virtualDataStartNode);
+        tempParentLink = startLink;
 
         /* Loop through the parent nodes */
-        while ((tempParentAddress != MPNode::EmptyAddress) || (tempParentAddress.isNull() && tempVirtualParentAddress != 0))
+        while (!tempParentLink.isEmpty())
         {
             /* Get pointer to next parent node */
-            tempNextParentNodePt = findNodeWithAddressInList(dataNodes, tempParentAddress, tempVirtualParentAddress);
+            tempNextParentNodePt = parentIndex.find(tempParentLink);
 
             /* Check that we could actually find it */
             if (!tempNextParentNodePt)
             {
-                qCritical() << "tagPointedNodes: couldn't find data parent node with address" << tempParentAddress.toHex() << "in our list";
+                qCritical() << "tagPointedNodes: couldn't find data parent node with address" << tempParentLink.toAddress().toHex() << "in our list";
 
                 if (repairAllowed)
                 {
-                    if ((!tempParentAddress.isNull() && tempParentAddress == startDataNode) || (tempParentAddress.isNull() && tempVirtualParentAddress == virtualDataStartNode))
+                    if (tempParentLink == startLink)
                     {
                         /* start node is incorrect */
                         startDataNode = QByteArray(MPNode::EmptyAddress);
@@ -1998,11 +2136,11 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
             else if (tempNextParentNodePt->getPointedToCheck())
             {
                 /* Linked chain loop detected */
-                qCritical() << "tagPointedNodes: data parent node loop has been detected: parent node with address" << tempParentNodePt->getAddress().toHex() << " points to parent node with address" << tempParentAddress.toHex();
+                qCritical() << "tagPointedNodes: data parent node loop has been detected: parent node with address" << tempParentNodePt->getAddress().toHex() << " points to parent node with address" << tempParentLink.toAddress().toHex();
 
                 if (repairAllowed)
                 {
-                    if ((!tempParentAddress.isNull() && tempParentAddress == startDataNode) || (tempParentAddress.isNull() && tempVirtualParentAddress == virtualDataStartNode))
+                    if (tempParentLink == startLink)
                     {
                         /* start node is already tagged... how's that even possible? */
                         startDataNode = QByteArray(MPNode::EmptyAddress);
@@ -2022,12 +2160,13 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
             else
             {
                 /* check previous node address */
-                if ((!tempParentAddress.isNull() && tempParentAddress == startDataNode) || (tempParentAddress.isNull() && tempVirtualParentAddress == virtualDataStartNode))
+                const MPNode::Link prevParentLink = tempNextParentNodePt->getPreviousParentLink();
+                if (tempParentLink == startLink)
                 {
                     /* first parent node: previous address should be an empty one */
-                    if ((tempNextParentNodePt->getPreviousParentAddress() != MPNode::EmptyAddress) || (tempNextParentNodePt->getPreviousParentAddress().isNull() && tempNextParentNodePt->getPreviousParentVirtualAddress() != 0))
+                    if (!prevParentLink.isEmpty())
                     {
-                        qWarning() << "tagPointedNodes: data parent node" << tempNextParentNodePt->getService() <<  "at address" << tempParentAddress.toHex() << "has incorrect previous address:" << tempNextParentNodePt->getPreviousParentAddress().toHex() << "instead of" << MPNode::EmptyAddress.toHex();
+                        qWarning() << "tagPointedNodes: data parent node" << tempNextParentNodePt->getService() <<  "at address" << tempParentLink.toAddress().toHex() << "has incorrect previous address:" << prevParentLink.toAddress().toHex() << "instead of" << MPNode::EmptyAddress.toHex();
                         if (repairAllowed)
                         {
                             tempNextParentNodePt->setPreviousParentAddress(MPNode::EmptyAddress);
@@ -2038,9 +2177,9 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
                 else
                 {
                     /* normal linked chain */
-                    if ((!tempNextParentNodePt->getPreviousParentAddress().isNull() && tempNextParentNodePt->getPreviousParentAddress() != tempParentNodePt->getAddress()) || (tempNextParentNodePt->getPreviousParentAddress().isNull() && tempNextParentNodePt->getPreviousParentVirtualAddress() != tempParentNodePt->getVirtualAddress()))
+                    if (prevParentLink != tempParentNodePt->getAddressLink())
                     {
-                        qWarning() << "tagPointedNodes: data parent node" << tempNextParentNodePt->getService() <<  "at address" << tempParentAddress.toHex() << "has incorrect previous address:" << tempNextParentNodePt->getPreviousParentAddress().toHex() << "instead of" << tempParentNodePt->getAddress().toHex();
+                        qWarning() << "tagPointedNodes: data parent node" << tempNextParentNodePt->getService() <<  "at address" << tempParentLink.toAddress().toHex() << "has incorrect previous address:" << prevParentLink.toAddress().toHex() << "instead of" << tempParentNodePt->getAddress().toHex();
                         if (repairAllowed)
                         {
                             tempNextParentNodePt->setPreviousParentAddress(tempParentNodePt->getAddress(), tempParentNodePt->getVirtualAddress());
@@ -2056,31 +2195,31 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
                 tempParentNodePt->setPointedToCheck();
 
                 /* get first child */
-                tempChildAddress = tempParentNodePt->getStartChildAddress();
-                tempVirtualChildAddress = tempParentNodePt->getStartChildVirtualAddress();
+                const MPNode::Link startChildLink = tempParentNodePt->getStartChildLink();
+                tempChildLink = startChildLink;
 
                 /* browse through all the children */
-                while ((tempChildAddress != MPNode::EmptyAddress) || (tempChildAddress.isNull() && tempVirtualChildAddress != 0))
+                while (!tempChildLink.isEmpty())
                 {
                     /* Get pointer to the child node */
-                    tempNextChildNodePt = findNodeWithAddressInList(dataChildNodes, tempChildAddress, tempVirtualChildAddress);
+                    tempNextChildNodePt = childIndex.find(tempChildLink);
 
                     /* Check we could find child pointer */
                     if (!tempNextChildNodePt)
                     {
-                        if ((!tempChildAddress.isNull() && tempChildAddress == tempParentNodePt->getStartChildAddress()) || (tempChildAddress.isNull() && tempVirtualChildAddress == tempParentNodePt->getStartChildVirtualAddress()))
+                        if (tempChildLink == startChildLink)
                         {
-                            qWarning() << "tagPointedNodes: couldn't find first data child node with address" << tempChildAddress.toHex() << " for parent " << tempParentNodePt->getService() << " in our list";
+                            qWarning() << "tagPointedNodes: couldn't find first data child node with address" << tempChildLink.toAddress().toHex() << " for parent " << tempParentNodePt->getService() << " in our list";
                         }
                         else
                         {
-                            qWarning() << "tagPointedNodes: couldn't find data child node with address" << tempChildAddress.toHex() << " for parent " << tempParentNodePt->getService() << " in our list";
+                            qWarning() << "tagPointedNodes: couldn't find data child node with address" << tempChildLink.toAddress().toHex() << " for parent " << tempParentNodePt->getService() << " in our list";
                         }
                         return_bool = false;
 
                         if (repairAllowed)
                         {
-                            if ((!tempChildAddress.isNull() && tempChildAddress == tempParentNodePt->getStartChildAddress()) || (tempChildAddress.isNull() && tempVirtualChildAddress == tempParentNodePt->getStartChildVirtualAddress()))
+                            if (tempChildLink == startChildLink)
                             {
                                 // first child
                                 tempParentNodePt->setStartChildAddress(MPNode::EmptyAddress);
@@ -2093,14 +2232,14 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
                         }
 
                         /* Loop to next parent */
-                        tempChildAddress = MPNode::EmptyAddress;
+                        tempChildLink = MPNode::Link{};
                     }
                     else if (tempNextChildNodePt->getPointedToCheck())
                     {
                         /* Linked chain loop detected */
-                        if ((!tempChildAddress.isNull() && tempChildAddress == tempParentNodePt->getStartChildAddress()) || (tempChildAddress.isNull() && tempVirtualChildAddress == tempParentNodePt->getStartChildVirtualAddress()))
+                        if (tempChildLink == startChildLink)
                         {
-                            qCritical() << "tagPointedNodes: data child node already pointed to: parent node with address" << tempParentAddress.toHex() << " points to child node with address" << tempChildAddress.toHex();
+                            qCritical() << "tagPointedNodes: data child node already pointed to: parent node with address" << tempParentLink.toAddress().toHex() << " points to child node with address" << tempChildLink.toAddress().toHex();
                             if (repairAllowed)
                             {
                                 tempParentNodePt->setStartChildAddress(MPNode::EmptyAddress);
@@ -2108,7 +2247,7 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
                         }
                         else
                         {
-                            qCritical() << "tagPointedNodes: data child node loop has been detected: child node with address" << tempChildNodePt->getAddress().toHex() << " points to child node with address" << tempChildAddress.toHex();
+                            qCritical() << "tagPointedNodes: data child node loop has been detected: child node with address" << tempChildNodePt->getAddress().toHex() << " points to child node with address" << tempChildLink.toAddress().toHex();
                             if (repairAllowed)
                             {
                                 tempChildNodePt->setNextChildDataAddress(MPNode::EmptyAddress);
@@ -2128,14 +2267,12 @@ bool MPDevice::tagPointedNodes(bool tagCredentials, bool tagData, bool repairAll
                         tempChildNodePt->setPointedToCheck();
 
                         /* Loop to next possible child */
-                        tempChildAddress = tempChildNodePt->getNextChildDataAddress();
-                        tempVirtualChildAddress = tempChildNodePt->getNextChildVirtualAddress();
+                        tempChildLink = tempChildNodePt->getNextChildDataLink();
                     }
                 }
 
                 /* get next parent address */
-                tempParentAddress = tempParentNodePt->getNextParentAddress();
-                tempVirtualParentAddress = tempParentNodePt->getNextParentVirtualAddress();
+                tempParentLink = tempParentNodePt->getNextParentLink();
             }
         }
     }
@@ -2178,7 +2315,7 @@ bool MPDevice::deleteDataParentChilds(MPNode *parentNodePt)
 
             /* Delete node */
             parentNodePt->removeChild(cur_child_pt);
-            dataChildNodes.removeOne(cur_child_pt);
+            removeNodeFromList(dataChildNodes, cur_child_pt);
         }
     }
 
@@ -2457,7 +2594,7 @@ MPNode* MPDevice::addNewServiceToDB(const QString &service, Common::AddressType
 
     NodeList& nodes = addrType == Common::CRED_ADDR_IDX ? loginNodes : webAuthnLoginNodes;
     /* Add node to list */
-    nodes.append(newNodePt);
+    appendNodeToList(nodes, newNodePt);
     addOrphanParentToDB(newNodePt, false, false, addrType);
 
     return newNodePt;
@@ -2722,11 +2859,11 @@ bool MPDevice::removeEmptyParentFromDB(MPNode* parentNodePt, bool isDataParent,
                         /* Delete object */
                         if (isDataParent)
                         {
-                            dataNodes.removeOne(parentNodePt);
+                            removeNodeFromList(dataNodes, parentNodePt);
                         }
                         else
                         {
-                            nodes.removeOne(parentNodePt);
+                            removeNodeFromList(nodes, parentNodePt);
                         }
                         delete parentNodePt;
                         tagPointedNodes(!isDataParent, isDataParent, false, addrType);
@@ -2748,11 +2885,11 @@ bool MPDevice::removeEmptyParentFromDB(MPNode* parentNodePt, bool isDataParent,
                         /* Delete object */
                         if (isDataParent)
                         {
-                            dataNodes.removeOne(parentNodePt);
+                            removeNodeFromList(dataNodes, parentNodePt);
                         }
                         else
                         {
-                            nodes.removeOne(parentNodePt);
+                            removeNodeFromList(nodes, parentNodePt);
                         }
                         delete parentNodePt;
                         tagPointedNodes(!isDataParent, isDataParent, false, addrType);
@@ -2857,7 +2994,7 @@ bool MPDevice::removeChildFromDB(MPNode* parentNodePt, MPNode* childNodePt, bool
                     parentNodePt->removeChild(childNodePt);
                     if (deleteFromList)
                     {
-                        childNodes.removeOne(childNodePt);
+                        removeNodeFromList(childNodes, childNodePt);
                         delete childNodePt;
                     }
 
@@ -2892,7 +3029,7 @@ bool MPDevice::removeChildFromDB(MPNode* parentNodePt, MPNode* childNodePt, bool
                     parentNodePt->removeChild(childNodePt);
                     if (deleteFromList)
                     {
-                        loginChildNodes.removeOne(childNodePt);
+                        removeNodeFromList(loginChildNodes, childNodePt);
                         delete childNodePt;
                     }
                     return true;
@@ -2991,7 +3128,7 @@ bool MPDevice::checkLoadedNodes(bool checkCredentials, bool checkData, bool repa
                 {
                     /* no other choice than to delete them (the ctr is in the parent node */
                     qDebug() << "Removing data child at address:" << nodeItem->getAddress().toHex();
-                    dataChildNodes.removeOne(nodeItem);
+                    removeNodeFromList(dataChildNodes, nodeItem);
                 }
                 nbOrphanDataChildren++;
             }
@@ -3141,7 +3278,6 @@ bool MPDevice::generateSavePackets(AsyncJobs *jobs, bool tackleCreds, bool tackl
 {
     qInfo() << "Generating Save Packets...";
     bool diagSavePacketsGenerated = false;
-    MPNode* temp_node_pointer;
     progressCurrent = 0;
     progressTotal = 0;
 
@@ -3172,67 +3308,18 @@ bool MPDevice::generateSavePackets(AsyncJobs *jobs, bool tackleCreds, bool tackl
     /* First pass: check the nodes that changed or were added */
     if (tackleCreds)
     {
-        diagSavePacketsGenerated |= checkModifiedSavePacketNodes(jobs, dataWriteProgressCb, Common::CRED_ADDR_IDX);
-        if (isBLE())
-        {
-            diagSavePacketsGenerated |= checkModifiedSavePacketNodes(jobs, dataWriteProgressCb, Common::WEBAUTHN_ADDR_IDX);
-        }
+        diagSavePacketsGenerated |= checkModifiedSavePacketNodes(jobs, dataWriteProgressCb, false);
     }
 
     if (tackleData)
     {
-        for (auto &nodelist_iterator: dataNodes)
-        {
-            /* See if we can find the same node in the clone list */
-            temp_node_pointer = findNodeWithAddressInList(dataNodesClone, nodelist_iterator->getAddress(), 0);
-
-            if (!temp_node_pointer)
-            {
-                qDebug() << "Generating save packet for new data service" << nodelist_iterator->getService();
-                addWriteNodePacketToJob(jobs, nodelist_iterator->getAddress(), nodelist_iterator->getNodeData(), dataWriteProgressCb);
-                diagSavePacketsGenerated = true;
-                progressTotal += 3;
-            }
-            else if (nodelist_iterator->getNodeData() != temp_node_pointer->getNodeData())
-            {
-                qDebug() << "Generating save packet for updated data service" << nodelist_iterator->getService();
-                addWriteNodePacketToJob(jobs, nodelist_iterator->getAddress(), nodelist_iterator->getNodeData(), dataWriteProgressCb);
-                diagSavePacketsGenerated = true;
-                progressTotal += 3;
-            }
-        }
-        for (auto &nodelist_iterator: dataChildNodes)
-        {
-            /* See if we can find the same node in the clone list */
-            temp_node_pointer = findNodeWithAddressInList(dataChildNodesClone, nodelist_iterator->getAddress(), 0);
-
-            if (!temp_node_pointer)
-            {
-                qDebug() << "Generating save packet for new data child node";
-                addWriteNodePacketToJob(jobs, nodelist_iterator->getAddress(), nodelist_iterator->getNodeData(), dataWriteProgressCb);
-                diagSavePacketsGenerated = true;
-                progressTotal += 3;
-            }
-            else if (nodelist_iterator->getNodeData() != temp_node_pointer->getNodeData())
-            {
-                qDebug() << "Generating save packet for updated data child node";
-                qDebug() << "Prev contents: " << temp_node_pointer->getNodeData().toHex();
-                qDebug() << "New  contents: " << nodelist_iterator->getNodeData().toHex();
-                addWriteNodePacketToJob(jobs, nodelist_iterator->getAddress(), nodelist_iterator->getNodeData(), dataWriteProgressCb);
-                diagSavePacketsGenerated = true;
-                progressTotal += 3;
-            }
-        }
+        diagSavePacketsGenerated |= checkModifiedSavePacketNodes(jobs, dataWriteProgressCb, true);
     }
 
     /* Second pass: check the nodes that were removed */
     if (tackleCreds)
     {
-        diagSavePacketsGenerated |= checkRemovedSavePacketNodes(jobs, dataWriteProgressCb, Common::CRED_ADDR_IDX);
-        if (isBLE())
-        {
-            diagSavePacketsGenerated |= checkRemovedSavePacketNodes(jobs, dataWriteProgressCb, Common::WEBAUTHN_ADDR_IDX);
-        }
+        diagSavePacketsGenerated |= checkRemovedSavePacketNodes(jobs, dataWriteProgressCb, false);
 
         /* Diff favorites */
         for (qint32 i = 0; i < favoritesAddrs.length(); i++)
@@ -3283,32 +3370,7 @@ bool MPDevice::generateSavePackets(AsyncJobs *jobs, bool tackleCreds, bool tackl
     }
     if (tackleData)
     {
-        for (auto &nodelist_iterator: dataNodesClone)
-        {
-            /* See if we can find the same node in the clone list */
-            temp_node_pointer = findNodeWithAddressInList(dataNodes, nodelist_iterator->getAddress(), 0);
-
-            if (!temp_node_pointer)
-            {
-                qDebug() << "Generating delete packet for deleted data service" << nodelist_iterator->getService();
-                addWriteNodePacketToJob(jobs, nodelist_iterator->getAddress(), QByteArray(pMesProt->getParentNodeSize(), 0xFF), dataWriteProgressCb);
-                diagSavePacketsGenerated = true;
-                progressTotal += 3;
-            }
-        }
-        for (auto &nodelist_iterator: dataChildNodesClone)
-        {
-            /* See if we can find the same node in the clone list */
-            temp_node_pointer = findNodeWithAddressInList(dataChildNodes, nodelist_iterator->getAddress(), 0);
-
-            if (!temp_node_pointer)
-            {
-                qDebug() << "Generating delete packet for deleted data child node";
-                addWriteNodePacketToJob(jobs, nodelist_iterator->getAddress(), QByteArray(pMesProt->getChildNodeSize(), 0xFF), dataWriteProgressCb);
-                diagSavePacketsGenerated = true;
-                progressTotal += 3;
-            }
-        }
+        diagSavePacketsGenerated |= checkRemovedSavePacketNodes(jobs, dataWriteProgressCb, true);
 
         /* Diff start data node */
         if (startDataNode != startDataNodeClone)
@@ -3370,100 +3432,105 @@ bool MPDevice::generateSavePackets(AsyncJobs *jobs, bool tackleCreds, bool tackl
     return diagSavePacketsGenerated;
 }
 
-bool MPDevice::checkModifiedSavePacketNodes(AsyncJobs *jobs, std::function<void()> writeCb, Common::AddressType addrType)
+static bool isDataNodeType(int type)
+{
+    return type == MPNode::NodeParentData || type == MPNode::NodeChildData;
+}
+
+bool MPDevice::checkModifiedSavePacketNodes(AsyncJobs *jobs, std::function<void()> writeCb, bool dataNodesPass)
 {
-    const bool isCred = addrType == Common::CRED_ADDR_IDX;
-    NodeList& nodes = isCred ? loginNodes : webAuthnLoginNodes;
-    NodeList& nodesClone = isCred ? loginNodesClone : webAuthnLoginNodesClone;
-    NodeList& childNodes = isCred? loginChildNodes : webAuthnLoginChildNodes;
-    NodeList& childNodesClone = isCred? loginChildNodesClone : webAuthnLoginChildNodesClone;
-    MPNode* tmpNodePtr;
     bool savePacketGenerated = false;
-    for (auto &nodelist_iterator: nodes)
+    for (const auto &entry : nodeChangeJournal.entries)
     {
-        /* See if we can find the same node in the clone list */
-        tmpNodePtr = findNodeWithAddressInList(nodesClone, nodelist_iterator->getAddress(), 0);
+        MPNode *node = entry.node;
+        if (!node || isDataNodeType(node->getType()) != dataNodesPass)
+        {
+            continue;
+        }
 
-        if (!tmpNodePtr)
+        /* Compare with the device contents at the node address,
+         * a node removed and added again at the same place is unchanged */
+        const QByteArray nodeAddress = node->getAddress();
+        QByteArray deviceData;
+        if (!entry.data.isNull() && entry.address == nodeAddress)
         {
-            qDebug() << "Generating save packet for new service" << nodelist_iterator->getService();
-            //qDebug() << "New  contents: " << nodelist_iterator->getNodeData().toHex();
-            addWriteNodePacketToJob(jobs, nodelist_iterator->getAddress(), nodelist_iterator->getNodeData(), writeCb);
-            savePacketGenerated = true;
-            progressTotal += 3;
+            deviceData = entry.data;
         }
-        else if (nodelist_iterator->getNodeData() != tmpNodePtr->getNodeData())
+        else
         {
-            qDebug() << "Generating save packet for updated service" << nodelist_iterator->getService();
-            //qDebug() << "Prev contents: " << temp_node_pointer->getNodeData().toHex();
-            //qDebug() << "New  contents: " << nodelist_iterator->getNodeData().toHex();
-            addWriteNodePacketToJob(jobs, nodelist_iterator->getAddress(), nodelist_iterator->getNodeData(), writeCb);
-            savePacketGenerated = true;
-            progressTotal += 3;
+            deviceData = nodeChangeJournal.removedNodes.value(nodeAddress).data;
         }
-    }
-    for (auto &nodelist_iterator: childNodes)
-    {
-        /* See if we can find the same node in the clone list */
-        tmpNodePtr = findNodeWithAddressInList(childNodesClone, nodelist_iterator->getAddress(), 0);
 
-        if (!tmpNodePtr)
+        if (deviceData.isNull())
+        {
+            qDebug() << "Generating save packet for new node at" << nodeAddress.toHex();
+        }
+        else if (deviceData != node->getNodeData())
         {
-            qDebug() << "Generating save packet for new login" << nodelist_iterator->getLogin();
-            //qDebug() << "New  contents: " << nodelist_iterator->getNodeData().toHex();
-            addWriteNodePacketToJob(jobs, nodelist_iterator->getAddress(), nodelist_iterator->getNodeData(), writeCb);
-            savePacketGenerated = true;
-            progressTotal += 3;
+            qDebug() << "Generating save packet for updated node at" << nodeAddress.toHex();
         }
-        else if (nodelist_iterator->getNodeData() != tmpNodePtr->getNodeData())
+        else
         {
-            qDebug() << "Generating save packet for updated login" << nodelist_iterator->getLogin();
-            addWriteNodePacketToJob(jobs, nodelist_iterator->getAddress(), nodelist_iterator->getNodeData(), writeCb);
-            savePacketGenerated = true;
-            progressTotal += 3;
+            continue;
         }
+        addWriteNodePacketToJob(jobs, nodeAddress, node->getNodeData(), writeCb);
+        savePacketGenerated = true;
+        progressTotal += 3;
     }
     return savePacketGenerated;
 }
 
-bool MPDevice::checkRemovedSavePacketNodes(AsyncJobs *jobs, std::function<void ()> writeCb, Common::AddressType addrType)
+bool MPDevice::checkRemovedSavePacketNodes(AsyncJobs *jobs, std::function<void ()> writeCb, bool dataNodesPass)
 {
-    const bool isCred = addrType == Common::CRED_ADDR_IDX;
-    NodeList& nodes = isCred ? loginNodes : webAuthnLoginNodes;
-    NodeList& nodesClone = isCred ? loginNodesClone : webAuthnLoginNodesClone;
-    NodeList& childNodes = isCred? loginChildNodes : webAuthnLoginChildNodes;
-    NodeList& childNodesClone = isCred? loginChildNodesClone : webAuthnLoginChildNodesClone;
-    MPNode* tmpNodePtr;
-    bool savePacketGenerated = false;
-    for (auto &nodelist_iterator : nodesClone)
+    /* Device locations freed by the removed and the moved nodes */
+    QMap<QByteArray, int> freedAddresses;
+    QSet<QByteArray> usedAddresses;
+    for (const auto &removed : nodeChangeJournal.removedNodes)
     {
-        /* See if we can find the same node in the clone list */
-        tmpNodePtr = findNodeWithAddressInList(nodes, nodelist_iterator->getAddress(), 0);
-
-        if (!tmpNodePtr)
+        freedAddresses.insert(removed.address, removed.type);
+    }
+    for (const auto &entry : nodeChangeJournal.entries)
+    {
+        if (!entry.node)
+        {
+            continue;
+        }
+        usedAddresses.insert(entry.node->getAddress());
+        if (!entry.data.isNull() && entry.address != entry.node->getAddress())
         {
-            qDebug() << "Generating delete packet for deleted service" << nodelist_iterator->getService();
-            addWriteNodePacketToJob(jobs, nodelist_iterator->getAddress(), QByteArray(getParentNodeSize(), 0xFF), writeCb);
-            savePacketGenerated = true;
-            progressTotal += 3;
+            freedAddresses.insert(entry.address, entry.type);
         }
     }
-    for (auto &nodelist_iterator : childNodesClone)
-    {
-        /* See if we can find the same node in the clone list */
-        tmpNodePtr = findNodeWithAddressInList(childNodes, nodelist_iterator->getAddress(), 0);
 
-        if (!tmpNodePtr)
+    bool savePacketGenerated = false;
+    for (auto it = freedAddresses.constBegin(); it != freedAddresses.constEnd(); ++it)
+    {
+        if (isDataNodeType(it.value()) != dataNodesPass || usedAddresses.contains(it.key()))
         {
-            qDebug() << "Generating delete packet for deleted login" << nodelist_iterator->getLogin();
-            addWriteNodePacketToJob(jobs, nodelist_iterator->getAddress(), QByteArray(getChildNodeSize(), 0xFF), writeCb);
-            savePacketGenerated = true;
-            progressTotal += 3;
+            continue;
         }
+
+        const bool isParent = it.value() == MPNode::NodeParent || it.value() == MPNode::NodeParentData;
+        qDebug() << "Generating delete packet for removed node at" << it.key().toHex();
+        addWriteNodePacketToJob(jobs, it.key(), QByteArray(isParent ? getParentNodeSize() : getChildNodeSize(), 0xFF), writeCb);
+        savePacketGenerated = true;
+        progressTotal += 3;
     }
     return savePacketGenerated;
 }
 
+void MPDevice::appendNodeToList(NodeList &list, MPNode *node)
+{
+    list.append(node);
+    nodeChangeJournal.recordAdded(node);
+}
+
+void MPDevice::removeNodeFromList(NodeList &list, MPNode *node)
+{
+    list.removeOne(node);
+    nodeChangeJournal.recordRemoved(node);
+}
+
 QByteArray MPDevice::getFreeAddress(quint32 virtualAddr)
 {
     const int virtAddr = static_cast<int>(virtualAddr);
@@ -4824,19 +4891,19 @@ quint64 MPDevice::getUInt64EncryptionKeyOld()
     return key;
 }
 
-QString MPDevice::encryptSimpleCrypt(const QByteArray &data, const QString &encryption)
+QString MPDevice::encryptSimpleCrypt(const QByteArray &data, quint64 key)
 {
     /* Encrypt payload */
     SimpleCrypt simpleCrypt;
-    simpleCrypt.setKey(getUInt64EncryptionKey(encryption));
+    simpleCrypt.setKey(key);
 
     return simpleCrypt.encryptToString(data);
 }
 
-QByteArray MPDevice::decryptSimpleCrypt(const QString &payload, const QString &encryption)
+QByteArray MPDevice::decryptSimpleCrypt(const QString &payload, quint64 key)
 {
     SimpleCrypt simpleCrypt;
-    simpleCrypt.setKey(getUInt64EncryptionKey(encryption));
+    simpleCrypt.setKey(key);
 
     return simpleCrypt.decryptToByteArray(payload);
 }
@@ -4959,7 +5026,7 @@ bool MPDevice::testCodeAgainstCleanDBChanges(AsyncJobs *jobs)
     temp_node = pMesProt->createMPNode(temp_node_pt->getNodeData(), this, temp_node_pt->getAddress(), temp_node_pt->getVirtualAddress());
     removeChildFromDB(loginNodes[0], temp_node_pt, true, true);
     addChildToDB(loginNodes[0], temp_node);
-    loginChildNodes.append(temp_node);
+    appendNodeToList(loginChildNodes, temp_node);
     checkLoadedNodes(true, true, true);
     if (generateSavePackets(jobs, true, true, ignoreProgressCb)) {qCritical() << "Removing & Adding First Child Node: test failed!";return false;} else qInfo() << "Removing & Adding First Child Node: passed!";
 
@@ -4969,7 +5036,7 @@ bool MPDevice::testCodeAgainstCleanDBChanges(AsyncJobs *jobs)
     temp_node = pMesProt->createMPNode(temp_node_pt->getNodeData(), this, temp_node_pt->getAddress(), temp_node_pt->getVirtualAddress());
     removeChildFromDB(loginNodes[0], temp_node_pt, true, true);
     addChildToDB(loginNodes[0], temp_node);
-    loginChildNodes.append(temp_node);
+    appendNodeToList(loginChildNodes, temp_node);
     checkLoadedNodes(true, true, true);
     if (generateSavePackets(jobs, true, true, ignoreProgressCb)) {qCritical() << "Removing & Adding Middle Child Node: test failed!";return false;} else qInfo() << "Removing & Adding Middle Child Node: passed!";
 
@@ -4980,7 +5047,7 @@ bool MPDevice::testCodeAgainstCleanDBChanges(AsyncJobs *jobs)
     temp_node = pMesProt->createMPNode(temp_node_pt->getNodeData(), this, temp_node_pt->getAddress(), temp_node_pt->getVirtualAddress());
     removeChildFromDB(loginNodes[0], temp_node_pt, true, true);
     addChildToDB(loginNodes[0], temp_node);
-    loginChildNodes.append(temp_node);
+    appendNodeToList(loginChildNodes, temp_node);
     checkLoadedNodes(true, true, true);
     if (generateSavePackets(jobs, true, true, ignoreProgressCb)) {qCritical() << "Removing & Adding Last Child Node: test failed!";return false;} else qInfo() << "Removing & Adding Last Child Node: passed!";
 
@@ -4990,9 +5057,9 @@ bool MPDevice::testCodeAgainstCleanDBChanges(AsyncJobs *jobs)
     temp_node = pMesProt->createMPNode(loginNodes[1]->getNodeData(), this, loginNodes[1]->getAddress(), loginNodes[1]->getVirtualAddress());
     temp_node->setStartChildAddress(MPNode::EmptyAddress, 0);
     removeChildFromDB(loginNodes[1], temp_node_pt, true, true);
-    loginNodes.append(temp_node);
+    appendNodeToList(loginNodes, temp_node);
     addOrphanParentToDB(temp_node, false, true);
-    loginChildNodes.append(temp_cnode);
+    appendNodeToList(loginChildNodes, temp_cnode);
     addChildToDB(temp_node, temp_cnode);
     checkLoadedNodes(true, true, true);
     if (generateSavePackets(jobs, true, true, ignoreProgressCb)) {qCritical() << "Removing & Adding Single Child Node: test failed!";return false;} else qInfo() << "Removing & Adding Single Child Node: passed!";
@@ -5001,7 +5068,7 @@ bool MPDevice::testCodeAgainstCleanDBChanges(AsyncJobs *jobs)
     return true;
 }
 
-QByteArray MPDevice::generateExportFileData(const QString &encryption)
+QJsonArray MPDevice::generateExportPayload()
 {
     QJsonArray exportTopArray = QJsonArray();
 
@@ -5099,8 +5166,14 @@ QByteArray MPDevice::generateExportFileData(const QString &encryption)
         bleImpl->generateExportData(exportTopArray);
     }
 
+    return exportTopArray;
+}
+
+QByteArray MPDevice::encodeExportFile(const QJsonArray &payloadArray, const QString &encryption, quint64 key,
+                                      quint8 credentialsDbChangeNumber, quint8 dataDbChangeNumber)
+{
     /* Generate file payload */
-    QJsonDocument payloadDoc(exportTopArray);
+    QJsonDocument payloadDoc(payloadArray);
     auto payload = payloadDoc.toJson();
 
     qDebug() << "requested encryption for exported DB:" << encryption;
@@ -5111,26 +5184,20 @@ QByteArray MPDevice::generateExportFileData(const QString &encryption)
     /* Export file content */
     QJsonObject exportTopObject;
 
-    QString enc = encryption;
-    if (enc == Common::SIMPLE_CRYPT || enc == Common::SIMPLE_CRYPT_V2)
+    if (encryption == Common::SIMPLE_CRYPT || encryption == Common::SIMPLE_CRYPT_V2)
     {
-        if (isBLE())
-        {
-            // For BLE using the new encryption
-            enc = Common::SIMPLE_CRYPT_V2;
-        }
-        exportTopObject.insert("encryption", enc);
-        exportTopObject.insert("payload", encryptSimpleCrypt(payload, enc));
+        exportTopObject.insert("encryption", encryption);
+        exportTopObject.insert("payload", encryptSimpleCrypt(payload, key));
     } else
     {
         // Fallback in case of an unknown encryption method where specified
-        qWarning() << "DB export: Unknown encryption " << enc << "is asked, fallback to 'none'";
+        qWarning() << "DB export: Unknown encryption " << encryption << "is asked, fallback to 'none'";
         exportTopObject.insert("encryption", "none");
         exportTopObject.insert("payload", QString(payload));
     }
 
-    exportTopObject.insert("dataDbChangeNumber", QJsonValue((quint8)get_dataDbChangeNumber()));
-    exportTopObject.insert("credentialsDbChangeNumber", QJsonValue((quint8)get_credentialsDbChangeNumber()));
+    exportTopObject.insert("dataDbChangeNumber", QJsonValue(dataDbChangeNumber));
+    exportTopObject.insert("credentialsDbChangeNumber", QJsonValue(credentialsDbChangeNumber));
 
     QJsonDocument fileContentDoc(exportTopObject);
     payload = fileContentDoc.toJson();
@@ -5138,16 +5205,8 @@ QByteArray MPDevice::generateExportFileData(const QString &encryption)
     return payload;
 }
 
-bool MPDevice::readExportFile(const QByteArray &fileData, QString &errorString)
+QJsonArray MPDevice::decodeExportFile(const QByteArray &fileData, quint64 key, quint64 keyOld, QString &errorString)
 {
-    /* When we add nodes, we give them an address based on this counter */
-    cleanMMMVars();
-    cleanImportedVars();
-
-    /* Local vars */
-    QJsonObject qjobject;
-    QJsonArray qjarray;
-
     /* Use a qjson document */
     QJsonDocument d = QJsonDocument::fromJson(fileData);
 
@@ -5156,22 +5215,19 @@ bool MPDevice::readExportFile(const QByteArray &fileData, QString &errorString)
     {
         qCritical() << "JSON document is empty";
         errorString = "Selected File Isn't Correct";
-        return false;
+        return QJsonArray();
     }
     else if (d.isNull())
     {
         qCritical() << "JSON document is null";
         errorString = "Selected File Isn't Correct";
-        return false;
+        return QJsonArray();
     }
 
     if (d.isArray())
     {
         /** Mooltiapp / Chrome App save file **/
-
-        /* Get the array */
-        QJsonArray dataArray = d.array();
-        return readExportPayload(dataArray, errorString);
+        return d.array();
     }
     else if (d.isObject())
     {
@@ -5184,70 +5240,93 @@ bool MPDevice::readExportFile(const QByteArray &fileData, QString &errorString)
             if ( encryptionMethod == Common::SIMPLE_CRYPT || encryptionMethod == Common::SIMPLE_CRYPT_V2 )
             {
                 QString payload = importFile.value("payload").toString();
-                auto decryptedData = decryptSimpleCrypt(payload, encryptionMethod);
+                auto decryptedData = decryptSimpleCrypt(payload, encryptionMethod == Common::SIMPLE_CRYPT_V2 ? key : keyOld);
 
                 QJsonDocument decryptedDocument = QJsonDocument::fromJson(decryptedData);
                 if (decryptedDocument.isArray())
                 {
                     /* Get the array */
-                    QJsonArray dataArray = decryptedDocument.array();
-                    return readExportPayload(dataArray, errorString);
+                    return decryptedDocument.array();
                 }
                 else
                 {
                     qCritical() << "Encrypted payload isn't correct";
                     errorString = "Selected File Is Another User's Backup";
-                    return false;
+                    return QJsonArray();
                 }
             }
             else if  (encryptionMethod == "none")
             {
                 /* Legacy, not generated anymore */
-                return readExportPayload(QJsonDocument::fromJson(importFile.value("payload").toString().toUtf8()).array(), errorString);
+                return QJsonDocument::fromJson(importFile.value("payload").toString().toUtf8()).array();
             }
             else
             {
                 errorString = "Unknown Encryption Method";
-                return false;
+                return QJsonArray();
             }
         }
 
         qInfo() << "File is a JSON object";
         errorString = "Selected File Isn't Correct";
-        return false;
+        return QJsonArray();
     }
     else
     {
         /* If it's not an array or an object... */
         errorString = "Selected File Isn't Correct";
-        return false;
+        return QJsonArray();
     }
 }
 
-void MPDevice::readExportNodes(QJsonArray &&nodes, ExportPayloadData id, bool fromMiniToBle /*= false*/)
+bool MPDevice::readExportFile(const QJsonArray &dataArray, QString &errorString)
 {
-    for (qint32 i = 0; i < nodes.size(); i++)
+    /* When we add nodes, we give them an address based on this counter */
+    cleanMMMVars();
+    cleanImportedVars();
+
+    if (!errorString.isEmpty())
+        return false;
+
+    return readExportPayload(dataArray, errorString);
+}
+
+bool MPDevice::readExportNodes(QJsonArray &&nodes, ExportPayloadData id, bool fromMiniToBle /*= false*/)
+{
+    const qint32 nodeCount = nodes.size();
+    QVector<QByteArray> serviceAddrs(nodeCount);
+    QVector<QByteArray> dataCores(nodeCount);
+    for (qint32 i = 0; i < nodeCount; i++)
     {
         QJsonObject qjobject = nodes[i].toObject();
 
         /* Fetch address */
         QJsonArray serviceAddrArr = qjobject["address"].toArray();
-        QByteArray serviceAddr = QByteArray();
+        QByteArray &serviceAddr = serviceAddrs[i];
         for (qint32 j = 0; j < serviceAddrArr.size(); j++) {serviceAddr.append(serviceAddrArr[j].toInt());}
 
         /* Fetch core data */
         QJsonObject dataObj = qjobject["data"].toObject();
-        QByteArray dataCore = QByteArray();
+        QByteArray &dataCore = dataCores[i];
+        dataCore.reserve(dataObj.size());
         for (qint32 j = 0; j < dataObj.size(); j++) {dataCore.append(dataObj[QString::number(j)].toInt());}
-        if (fromMiniToBle)
-        {
-            bleImpl->convertMiniToBleNode(dataCore);
-        }
+    }
 
-        /* Recreate node and add it to the list of imported nodes */
-        MPNode* importedNode = pMesProt->createMPNode(qMove(dataCore), this, qMove(serviceAddr), 0);
-        importNodeMap[id]->append(importedNode);
+    /* Mini nodes are converted all at once on worker threads */
+    if (fromMiniToBle && !bleImpl->convertMiniToBleNodes(dataCores))
+    {
+        return false;
     }
+
+    /* Recreate nodes and add them to the list of imported nodes */
+    auto *importedNodes = importNodeMap[id];
+    importedNodes->reserve(importedNodes->size() + nodeCount);
+    for (qint32 i = 0; i < nodeCount; i++)
+    {
+        MPNode* importedNode = pMesProt->createMPNode(qMove(dataCores[i]), this, qMove(serviceAddrs[i]), 0);
+        importedNodes->append(importedNode);
+    }
+    return true;
 }
 
 bool MPDevice::readExportPayload(QJsonArray dataArray, QString &errorString)
@@ -5374,11 +5453,14 @@ bool MPDevice::readExportPayload(QJsonArray dataArray, QString &errorString)
         importedFavoritesAddrs.append(qbarray);
     }
 
-    /* Read service nodes */
-    readExportNodes(dataArray[EXPORT_SERVICE_NODES_INDEX].toArray(), EXPORT_SERVICE_NODES_INDEX, miniExportToBle);
-
-    /* Read service child nodes */
-    readExportNodes(dataArray[EXPORT_SERVICE_CHILD_NODES_INDEX].toArray(), EXPORT_SERVICE_CHILD_NODES_INDEX, miniExportToBle);
+    /* Read service nodes and service child nodes */
+    if (!readExportNodes(dataArray[EXPORT_SERVICE_NODES_INDEX].toArray(), EXPORT_SERVICE_NODES_INDEX, miniExportToBle) ||
+        !readExportNodes(dataArray[EXPORT_SERVICE_CHILD_NODES_INDEX].toArray(), EXPORT_SERVICE_CHILD_NODES_INDEX, miniExportToBle))
+    {
+        qCritical() << "Invalid Mini nodes in export file";
+        errorString = "Selected File Isn't Correct";
+        return false;
+    }
 
     if (!isMooltiAppImportFile)
     {
@@ -5454,6 +5536,7 @@ void MPDevice::cleanMMMVars(void)
     clearAndDelete(loginNodesClone);
     clearAndDelete(dataNodesClone);
     favoritesAddrsClone.clear();
+    nodeChangeJournal.clear();
     freeAddresses.clear();
     if (isBLE())
     {
@@ -5494,22 +5577,19 @@ void MPDevice::startImportFileMerging(const MPDeviceProgressCb &cbProgress, Mess
         if (!isBLE())
         {
             /// Know if we need to add CPZ CTR packets (additive process)
-            for (qint32 i = 0; i < importedCpzCtrValue.size(); i++)
+            QSet<QByteArray> knownCpzCtr;
+            for (const QByteArray &cpzCtr : cpzCtrValue)
             {
-                bool cpzFound = false;
-                for (qint32 j = 0; j < cpzCtrValue.size(); j++)
-                {
-                    if (cpzCtrValue[j] == importedCpzCtrValue[i])
-                    {
-                        cpzFound = true;
-                        break;
-                    }
-                }
+                knownCpzCtr.insert(cpzCtr);
+            }
 
-                if (!cpzFound)
+            for (const QByteArray &cpzCtr : importedCpzCtrValue)
+            {
+                if (!knownCpzCtr.contains(cpzCtr))
                 {
-                    qDebug() << "CPZ CTR not in our DB: " << importedCpzCtrValue[i].toHex();
-                    cpzCtrValue.append(importedCpzCtrValue[i]);
+                    qDebug() << "CPZ CTR not in our DB: " << cpzCtr.toHex();
+                    cpzCtrValue.append(cpzCtr);
+                    knownCpzCtr.insert(cpzCtr);
                 }
             }
         }
@@ -5523,6 +5603,7 @@ void MPDevice::startImportFileMerging(const MPDeviceProgressCb &cbProgress, Mess
             ctrValue = QByteArray(importedCtrValue);
         }
 
+        importMergeStats = ImportMergeStats();
         if (!checkImportedLoginNodes(cb, Common::CRED_ADDR_IDX))
         {
             qCritical() << "Login import failed";
@@ -5550,6 +5631,7 @@ void MPDevice::startImportFileMerging(const MPDeviceProgressCb &cbProgress, Mess
             }
         }
 
+        logImportMergeStats(noDelete);
         qInfo() << newAddressesNeededCounter << " addresses are required for merge operations ";
 
         /* If we need addresses, query them */
@@ -5723,136 +5805,146 @@ bool MPDevice::checkImportedLoginNodes(const MessageHandlerCb &cb, Common::Addre
     NodeList& importChildNodes = isCred ? importedLoginChildNodes : importedWebauthnLoginChildNodes;
     NodeList& nodes = isCred ? loginNodes : webAuthnLoginNodes;
     NodeList& childNodes = isCred? loginChildNodes : webAuthnLoginChildNodes;
+
+    /// Index both sides once so that every imported node is matched in constant time
+    QHash<QByteArray, MPNode*> nodesByCoreData;
+    nodesByCoreData.reserve(nodes.size() + importNodes.size());
+    for (MPNode* node : nodes)
+    {
+        const QByteArray coreData = node->getLoginNodeData();
+        if (!nodesByCoreData.contains(coreData))
+        {
+            nodesByCoreData.insert(coreData, node);
+        }
+    }
+    NodeAddressIndex childNodesIndex = indexNodesByAddress(childNodes);
+    const NodeAddressIndex importChildNodesIndex = indexNodesByAddress(importChildNodes);
+
     /// Find the nodes we don't have in memory or that have been changed
     for (qint32 i = 0; i < importNodes.size(); i++)
     {
-        bool service_node_found = false;
+        MPNode* matchedNode = nodesByCoreData.value(importNodes[i]->getLoginNodeData());
 
-        // Loop in the memory nodes to compare data
-        for (qint32 j = 0; j < nodes.size(); j++)
+        if (matchedNode)
         {
-            if (importNodes[i]->getLoginNodeData() == nodes[j]->getLoginNodeData())
-            {
-                // We found a parent node that has the same core data (doesn't mean the same prev / next node though!)
-                //qDebug() << "Parent node core data match for " << importNodes[i]->getService();
-                nodes[j]->setMergeTagged();
-                service_node_found = true;
+            // We found a parent node that has the same core data (doesn't mean the same prev / next node though!)
+            //qDebug() << "Parent node core data match for " << importNodes[i]->getService();
+            matchedNode->setMergeTagged();
+            importMergeStats.parentsMatched++;
 
-                // Next step is to check if the children are the same
-                quint32 cur_import_child_node_addr_v = importNodes[i]->getStartChildVirtualAddress();
-                QByteArray cur_import_child_node_addr = importNodes[i]->getStartChildAddress();
-                quint32 matched_parent_first_child_v = nodes[j]->getStartChildVirtualAddress();
-                QByteArray matched_parent_first_child = nodes[j]->getStartChildAddress();
+            // Next step is to check if the children are the same
+            quint32 cur_import_child_node_addr_v = importNodes[i]->getStartChildVirtualAddress();
+            QByteArray cur_import_child_node_addr = importNodes[i]->getStartChildAddress();
+            quint32 matched_parent_first_child_v = matchedNode->getStartChildVirtualAddress();
+            QByteArray matched_parent_first_child = matchedNode->getStartChildAddress();
 
-                /* Special case: parent doesn't have children but we do */
-                if (((cur_import_child_node_addr == MPNode::EmptyAddress) || (cur_import_child_node_addr.isNull() && cur_import_child_node_addr_v == 0)) && ((matched_parent_first_child != MPNode::EmptyAddress) || (matched_parent_first_child.isNull() && matched_parent_first_child_v != 0)))
-                {
-                    nodes[j]->setStartChildAddress(MPNode::EmptyAddress);
-                }
+            /* Special case: parent doesn't have children but we do */
+            if (((cur_import_child_node_addr == MPNode::EmptyAddress) || (cur_import_child_node_addr.isNull() && cur_import_child_node_addr_v == 0)) && ((matched_parent_first_child != MPNode::EmptyAddress) || (matched_parent_first_child.isNull() && matched_parent_first_child_v != 0)))
+            {
+                matchedNode->setStartChildAddress(MPNode::EmptyAddress);
+            }
 
-                //qDebug() << "First child address for imported node: " << cur_import_child_node_addr.toHex() << " , for own node: " << matched_parent_first_child.toHex();
-                while ((cur_import_child_node_addr != MPNode::EmptyAddress) || (cur_import_child_node_addr.isNull() && cur_import_child_node_addr_v != 0))
+            // Logins of the matched parent children, only needed if the imported parent has children
+            QHash<QString, MPNode*> childrenByLogin;
+            if ((cur_import_child_node_addr != MPNode::EmptyAddress) || (cur_import_child_node_addr.isNull() && cur_import_child_node_addr_v != 0))
+            {
+                QByteArray matched_parent_next_child = QByteArray(matched_parent_first_child);
+                quint32 matched_parent_next_child_v = matched_parent_first_child_v;
+                while ((matched_parent_next_child != MPNode::EmptyAddress) || (matched_parent_next_child.isNull() && matched_parent_next_child_v != 0))
                 {
-                    // Find the imported child node in our list
-                    MPNode* imported_child_node = findNodeWithAddressInList(importChildNodes, cur_import_child_node_addr, cur_import_child_node_addr_v);
+                    // Find the child node at this address
+                    MPNode* cur_child_node = childNodesIndex.find(matched_parent_next_child, matched_parent_next_child_v);
 
-                    // Check if we actually found the node
-                    if (!imported_child_node)
+                    if (!cur_child_node)
                     {
                         cleanImportedVars();
                         exitMemMgmtMode(false);
-                        cb(false, "Couldn't Import Database: Corrupted Export File");
-                        qCritical() << "Couldn't find imported child node in our list (corrupted import file?)";
+                        cb(false, "Couldn't Import Database: Please Run Integrity Check");
+                        qCritical() << "Couldn't find child node in our list (bad node reading?)";
                         return false;
                     }
 
-                    // We found the imported child, now we need to find the one that matches
-                    //qDebug() << "Looking for child " + imported_child_node->getLogin() + " in the Mooltipass";
-
-                    // Try to find the match between the child nodes of the matched parent
-                    bool matched_login_found = false;
-                    QByteArray matched_parent_next_child = QByteArray(matched_parent_first_child);
-                    quint32 matched_parent_next_child_v = matched_parent_first_child_v;
-                    while (((matched_parent_next_child != MPNode::EmptyAddress) || (matched_parent_next_child.isNull() && matched_parent_next_child_v != 0)) && (matched_login_found == false))
+                    if (!childrenByLogin.contains(cur_child_node->getLogin()))
                     {
-                        // Find the child node at this address
-                        MPNode* cur_child_node = findNodeWithAddressInList(childNodes, matched_parent_next_child, matched_parent_next_child_v);
+                        childrenByLogin.insert(cur_child_node->getLogin(), cur_child_node);
+                    }
 
-                        if (!cur_child_node)
-                        {
-                            cleanImportedVars();
-                            exitMemMgmtMode(false);
-                            cb(false, "Couldn't Import Database: Please Run Integrity Check");
-                            qCritical() << "Couldn't find child node in our list (bad node reading?)";
-                            return false;
-                        }
+                    matched_parent_next_child = cur_child_node->getNextChildAddress();
+                    matched_parent_next_child_v = cur_child_node->getNextChildVirtualAddress();
+                }
+            }
 
-                        // We found the child, now we can compare the login name
-                        if (cur_child_node->getLogin() == imported_child_node->getLogin())
-                        {
-                            // We have a match between imported login node & current login node
-                            //qDebug() << "Child found in the mooltipass, comparing rest of the data";
-                            cur_child_node->setMergeTagged();
-                            matched_login_found = true;
+            //qDebug() << "First child address for imported node: " << cur_import_child_node_addr.toHex() << " , for own node: " << matched_parent_first_child.toHex();
+            while ((cur_import_child_node_addr != MPNode::EmptyAddress) || (cur_import_child_node_addr.isNull() && cur_import_child_node_addr_v != 0))
+            {
+                // Find the imported child node in our list
+                MPNode* imported_child_node = importChildNodesIndex.find(cur_import_child_node_addr, cur_import_child_node_addr_v);
 
-                            if (cur_child_node->getLoginChildNodeData() == imported_child_node->getLoginChildNodeData())
-                            {
-                                //qDebug() << importNodes[i]->getService() << " : child core data match for child " << imported_child_node->getLogin() << " , nothing to do";
-                            }
-                            else
-                            {
-                                // Data mismatch, overwrite the important part
-                                qDebug() << importNodes[i]->getService() << " : child core data mismatch for child " << imported_child_node->getLogin() << " , updating...";
-                                cur_child_node->setLoginChildNodeData(imported_child_node->getNodeFlags(), imported_child_node->getLoginChildNodeData());
-                            }
-                            break;
-                        }
-                        else
-                        {
-                            // Not a match, load next child address in var
-                            matched_parent_next_child = cur_child_node->getNextChildAddress();
-                            matched_parent_next_child_v = cur_child_node->getNextChildVirtualAddress();
-                        }
-                    }
+                // Check if we actually found the node
+                if (!imported_child_node)
+                {
+                    cleanImportedVars();
+                    exitMemMgmtMode(false);
+                    cb(false, "Couldn't Import Database: Corrupted Export File");
+                    qCritical() << "Couldn't find imported child node in our list (corrupted import file?)";
+                    return false;
+                }
 
+                // Try to find the match between the child nodes of the matched parent
+                MPNode* cur_child_node = childrenByLogin.value(imported_child_node->getLogin());
+                if (cur_child_node)
+                {
+                    // We have a match between imported login node & current login node
+                    cur_child_node->setMergeTagged();
+                    importMergeStats.childrenMatched++;
+
+                    if (cur_child_node->getLoginChildNodeData() == imported_child_node->getLoginChildNodeData())
+                    {
+                        //qDebug() << importNodes[i]->getService() << " : child core data match for child " << imported_child_node->getLogin() << " , nothing to do";
+                    }
+                    else
+                    {
+                        // Data mismatch, overwrite the important part
+                        qDebug() << importNodes[i]->getService() << " : child core data mismatch for child " << imported_child_node->getLogin() << " , updating...";
+                        cur_child_node->setLoginChildNodeData(imported_child_node->getNodeFlags(), imported_child_node->getLoginChildNodeData());
+                        importMergeStats.childrenUpdated++;
+                    }
+                }
+                else
+                {
                     // If we couldn't find the child node, we have to add it
-                    if(matched_login_found == false)
+                    qDebug() << importNodes[i]->getService() << " : adding new child " << imported_child_node->getLogin() << " in the mooltipass...";
+
+                    /* Increment new addresses counter */
+                    incrementNeededAddresses(MPNode::NodeChild);
+
+                    /* Create new node with null address and virtual address set to our counter value */
+                    MPNode* newChildNodePt = pMesProt->createMPNode(QByteArray(getChildNodeSize(), 0), this, QByteArray(), newAddressesNeededCounter);
+                    newChildNodePt->setType(MPNode::NodeChild);
+                    newChildNodePt->setLoginChildNodeData(imported_child_node->getNodeFlags(), imported_child_node->getLoginChildNodeData());
+                    newChildNodePt->setMergeTagged();
+
+                    /* Add node to list */
+                    appendNodeToList(childNodes, newChildNodePt);
+                    childNodesIndex.insert(newChildNodePt);
+                    childrenByLogin.insert(newChildNodePt->getLogin(), newChildNodePt);
+                    importMergeStats.childrenAdded++;
+                    if (!addChildToDB(matchedNode, newChildNodePt, addrType))
                     {
-                        qDebug() << importNodes[i]->getService() << " : adding new child " << imported_child_node->getLogin() << " in the mooltipass...";
-
-                        /* Increment new addresses counter */
-                        incrementNeededAddresses(MPNode::NodeChild);
-
-                        /* Create new node with null address and virtual address set to our counter value */
-                        MPNode* newChildNodePt = pMesProt->createMPNode(QByteArray(getChildNodeSize(), 0), this, QByteArray(), newAddressesNeededCounter);
-                        newChildNodePt->setType(MPNode::NodeChild);
-                        newChildNodePt->setLoginChildNodeData(imported_child_node->getNodeFlags(), imported_child_node->getLoginChildNodeData());
-                        newChildNodePt->setMergeTagged();
-
-                        /* Add node to list */
-                        childNodes.append(newChildNodePt);
-                        if (!addChildToDB(nodes[j], newChildNodePt, addrType))
-                        {
-                            cleanImportedVars();
-                            exitMemMgmtMode(false);
-                            cb(false, "Couldn't Import Database: Please Run Integrity Check");
-                            qCritical() << "Couldn't add new child node to DB (corrupted DB?)";
-                            return false;
-                        }
+                        cleanImportedVars();
+                        exitMemMgmtMode(false);
+                        cb(false, "Couldn't Import Database: Please Run Integrity Check");
+                        qCritical() << "Couldn't add new child node to DB (corrupted DB?)";
+                        return false;
                     }
-
-                    // Process the next imported child node
-                    cur_import_child_node_addr = imported_child_node->getNextChildAddress();
-                    cur_import_child_node_addr_v = imported_child_node->getNextChildVirtualAddress();
                 }
 
-                // Jump to next service node
-                break;
+                // Process the next imported child node
+                cur_import_child_node_addr = imported_child_node->getNextChildAddress();
+                cur_import_child_node_addr_v = imported_child_node->getNextChildVirtualAddress();
             }
         }
-
-        // Did we find the service core data?
-        if(service_node_found == false)
+        else
         {
            /* Increment new addresses counter */
            incrementNeededAddresses(MPNode::NodeParent);
@@ -5864,7 +5956,9 @@ bool MPDevice::checkImportedLoginNodes(const MessageHandlerCb &cb, Common::Addre
            newNodePt->setMergeTagged();
 
            /* Add node to list */
-           nodes.append(newNodePt);
+           appendNodeToList(nodes, newNodePt);
+           nodesByCoreData.insert(newNodePt->getLoginNodeData(), newNodePt);
+           importMergeStats.parentsAdded++;
            if (!addOrphanParentToDB(newNodePt, false, false, addrType))
            {
                cleanImportedVars();
@@ -5879,7 +5973,7 @@ bool MPDevice::checkImportedLoginNodes(const MessageHandlerCb &cb, Common::Addre
            while (curImportChildAddr != MPNode::EmptyAddress)
            {
                /* Find node in list */
-               MPNode* curImportChildPt = findNodeWithAddressInList(importChildNodes, curImportChildAddr);
+               MPNode* curImportChildPt = importChildNodesIndex.find(curImportChildAddr);
 
                if (!curImportChildPt)
                {
@@ -5900,7 +5994,9 @@ bool MPDevice::checkImportedLoginNodes(const MessageHandlerCb &cb, Common::Addre
                newChildNodePt->setMergeTagged();
 
                /* Add node to list */
-               childNodes.append(newChildNodePt);
+               appendNodeToList(childNodes, newChildNodePt);
+               childNodesIndex.insert(newChildNodePt);
+               importMergeStats.childrenAdded++;
                if (!addChildToDB(newNodePt, newChildNodePt, addrType))
                {
                    cleanImportedVars();
@@ -5920,158 +6016,172 @@ bool MPDevice::checkImportedLoginNodes(const MessageHandlerCb &cb, Common::Addre
 
 bool MPDevice::checkImportedDataNodes(const MessageHandlerCb &cb)
 {
+    /// Index both sides once, data parents are matched on service and data counter
+    QHash<QPair<QString, QByteArray>, MPNode*> dataNodesByService;
+    dataNodesByService.reserve(dataNodes.size());
+    for (MPNode* node : dataNodes)
+    {
+        const auto key = qMakePair(node->getService(), node->getStartDataCtr());
+        if (!dataNodesByService.contains(key))
+        {
+            dataNodesByService.insert(key, node);
+        }
+    }
+    NodeAddressIndex dataChildNodesIndex = indexNodesByAddress(dataChildNodes);
+    const NodeAddressIndex importedDataChildNodesIndex = indexNodesByAddress(importedDataChildNodes);
+
     /// Find the data nodes we don't have in memory or that have been changed
     for (qint32 i = 0; i < importedDataNodes.size(); i++)
     {
         bool service_node_found = false;
         quint32 encDataSize = 0;
 
-        // Loop in the memory nodes to compare data
-        for (qint32 j = 0; j < dataNodes.size(); j++)
+        MPNode* matchedNode = dataNodesByService.value(qMakePair(importedDataNodes[i]->getService(), importedDataNodes[i]->getStartDataCtr()));
+        if (matchedNode)
         {
-            if ((importedDataNodes[i]->getService() == dataNodes[j]->getService()) && (importedDataNodes[i]->getStartDataCtr() == dataNodes[j]->getStartDataCtr()))
+            // We found a parent data node that has the same core data (doesn't mean the same prev / next node though!)
+            qDebug() << "Data parent node core data match for " << importedDataNodes[i]->getService();
+            matchedNode->setMergeTagged();
+            service_node_found = true;
+            importMergeStats.dataParentsMatched++;
+
+            // Next step is to check if the children are the same
+            quint32 cur_import_child_node_addr_v = importedDataNodes[i]->getStartChildVirtualAddress();
+            QByteArray cur_import_child_node_addr = importedDataNodes[i]->getStartChildAddress();
+            quint32 cur_matched_child_node_addr_v = matchedNode->getStartChildVirtualAddress();
+            QByteArray cur_matched_child_node_addr = matchedNode->getStartChildAddress();
+            MPNode* prev_matched_child_node = nullptr;
+            MPNode* matched_child_node = nullptr;
+            bool data_match_ongoing = true;
+
+            /* Special case: parent doesn't have children but we do */
+            if (((cur_import_child_node_addr == MPNode::EmptyAddress) || (cur_import_child_node_addr.isNull() && cur_import_child_node_addr_v == 0)) && ((cur_matched_child_node_addr != MPNode::EmptyAddress) || (cur_matched_child_node_addr.isNull() && cur_matched_child_node_addr_v != 0)))
             {
-                // We found a parent data node that has the same core data (doesn't mean the same prev / next node though!)
-                qDebug() << "Data parent node core data match for " << importedDataNodes[i]->getService();
-                dataNodes[j]->setMergeTagged();
-                service_node_found = true;
+                matchedNode->setStartChildAddress(MPNode::EmptyAddress);
+            }
 
-                // Next step is to check if the children are the same
-                quint32 cur_import_child_node_addr_v = importedDataNodes[i]->getStartChildVirtualAddress();
-                QByteArray cur_import_child_node_addr = importedDataNodes[i]->getStartChildAddress();
-                quint32 cur_matched_child_node_addr_v = dataNodes[j]->getStartChildVirtualAddress();
-                QByteArray cur_matched_child_node_addr = dataNodes[j]->getStartChildAddress();
-                MPNode* prev_matched_child_node = nullptr;
-                MPNode* matched_child_node = nullptr;
-                bool data_match_ongoing = true;
+            //qDebug() << "First child address for imported data node: " << cur_import_child_node_addr.toHex() << " , for own node: " << matched_parent_first_child.toHex();
+            while ((cur_import_child_node_addr != MPNode::EmptyAddress) || (cur_import_child_node_addr.isNull() && cur_import_child_node_addr_v != 0))
+            {
+                // Find the imported child node in our list
+                MPNode* imported_child_node = importedDataChildNodesIndex.find(cur_import_child_node_addr, cur_import_child_node_addr_v);
+                encDataSize += MP_NODE_DATA_ENC_SIZE;
 
-                /* Special case: parent doesn't have children but we do */
-                if (((cur_import_child_node_addr == MPNode::EmptyAddress) || (cur_import_child_node_addr.isNull() && cur_import_child_node_addr_v == 0)) && ((cur_matched_child_node_addr != MPNode::EmptyAddress) || (cur_matched_child_node_addr.isNull() && cur_matched_child_node_addr_v != 0)))
+                // Check if we actually found the node
+                if (!imported_child_node)
                 {
-                    dataNodes[j]->setStartChildAddress(MPNode::EmptyAddress);
+                    cleanImportedVars();
+                    exitMemMgmtMode(false);
+                    cb(false, "Couldn't Import Database: Corrupted Import File");
+                    qCritical() << "Couldn't find imported data child node in our list (corrupted import file?)";
+                    return false;
                 }
 
-                //qDebug() << "First child address for imported data node: " << cur_import_child_node_addr.toHex() << " , for own node: " << matched_parent_first_child.toHex();
-                while ((cur_import_child_node_addr != MPNode::EmptyAddress) || (cur_import_child_node_addr.isNull() && cur_import_child_node_addr_v != 0))
+                // If we are still matching, check that we still can
+                if (data_match_ongoing)
                 {
-                    // Find the imported child node in our list
-                    MPNode* imported_child_node = findNodeWithAddressInList(importedDataChildNodes, cur_import_child_node_addr, cur_import_child_node_addr_v);
-                    encDataSize += MP_NODE_DATA_ENC_SIZE;
-
-                    // Check if we actually found the node
-                    if (!imported_child_node)
+                    if ((cur_matched_child_node_addr == MPNode::EmptyAddress) || (cur_matched_child_node_addr.isNull() && cur_matched_child_node_addr_v == 0))
                     {
-                        cleanImportedVars();
-                        exitMemMgmtMode(false);
-                        cb(false, "Couldn't Import Database: Corrupted Import File");
-                        qCritical() << "Couldn't find imported data child node in our list (corrupted import file?)";
-                        return false;
+                        /* No next node */
+                        qDebug() << "Matched imported data child node chain is longer than what we have";
+                        data_match_ongoing = false;
                     }
-
-                    // If we are still matching, check that we still can
-                    if (data_match_ongoing)
+                    else
                     {
-                        if ((cur_matched_child_node_addr == MPNode::EmptyAddress) || (cur_matched_child_node_addr.isNull() && cur_matched_child_node_addr_v == 0))
+                        matched_child_node = dataChildNodesIndex.find(cur_matched_child_node_addr, cur_matched_child_node_addr_v);
+
+                        // Check if we actually found the node
+                        if (!matched_child_node)
                         {
-                            /* No next node */
-                            qDebug() << "Matched imported data child node chain is longer than what we have";
-                            data_match_ongoing = false;
+                            cleanImportedVars();
+                            exitMemMgmtMode(false);
+                            cb(false, "Couldn't Import Database: Please Run Integrity Check");
+                            qCritical() << "Couldn't find imported data child node in our list (corrupted DB?)";
+                            return false;
                         }
-                        else
-                        {
-                            matched_child_node = findNodeWithAddressInList(dataChildNodes, cur_matched_child_node_addr, cur_matched_child_node_addr_v);
 
-                            // Check if we actually found the node
-                            if (!matched_child_node)
-                            {
-                                cleanImportedVars();
-                                exitMemMgmtMode(false);
-                                cb(false, "Couldn't Import Database: Please Run Integrity Check");
-                                qCritical() << "Couldn't find imported data child node in our list (corrupted DB?)";
-                                return false;
-                            }
+                        // Check for data match
+                        if (matched_child_node->getDataChildNodeData() != imported_child_node->getDataChildNodeData())
+                        {
+                            qDebug() << "Data child node mismatch for " << importedDataNodes[i]->getService();
+                            data_match_ongoing = false;
 
-                            // Check for data match
-                            if (matched_child_node->getDataChildNodeData() != imported_child_node->getDataChildNodeData())
+                            /* Chain broken, delete all following data blocks */
+                            while ((cur_matched_child_node_addr != MPNode::EmptyAddress) || (cur_matched_child_node_addr.isNull() && cur_matched_child_node_addr_v != 0))
                             {
-                                qDebug() << "Data child node mismatch for " << importedDataNodes[i]->getService();
-                                data_match_ongoing = false;
+                                matched_child_node = dataChildNodesIndex.find(cur_matched_child_node_addr, cur_matched_child_node_addr_v);
 
-                                /* Chain broken, delete all following data blocks */
-                                while ((cur_matched_child_node_addr != MPNode::EmptyAddress) || (cur_matched_child_node_addr.isNull() && cur_matched_child_node_addr_v != 0))
+                                // Check if we actually found the node
+                                if (!matched_child_node)
                                 {
-                                    matched_child_node = findNodeWithAddressInList(dataChildNodes, cur_matched_child_node_addr, cur_matched_child_node_addr_v);
-
-                                    // Check if we actually found the node
-                                    if (!matched_child_node)
-                                    {
-                                        cleanImportedVars();
-                                        exitMemMgmtMode(false);
-                                        cb(false, "Couldn't Import Database: Please Run Integrity Check");
-                                        qCritical() << "Couldn't find imported data child node in our list (corrupted DB?)";
-                                        return false;
-                                    }
-
-                                    /* Next item */
-                                    cur_matched_child_node_addr = matched_child_node->getNextChildDataAddress();
-                                    cur_matched_child_node_addr_v = matched_child_node->getNextChildVirtualAddress();
-
-                                    /* Delete current block */
-                                    dataChildNodes.removeOne(matched_child_node);
+                                    cleanImportedVars();
+                                    exitMemMgmtMode(false);
+                                    cb(false, "Couldn't Import Database: Please Run Integrity Check");
+                                    qCritical() << "Couldn't find imported data child node in our list (corrupted DB?)";
+                                    return false;
                                 }
-                            }
-                            else
-                            {
-                                matched_child_node->setMergeTagged();
-                            }
-                        }
-                    }
-
-                    // If we stopped matching the child nodes, add child node data
-                    if (!data_match_ongoing)
-                    {
-                        qDebug() << importedDataNodes[i]->getService() << " : appending child data in the mooltipass...";
-
-                        /* Increment new addresses counter */
-                        incrementNeededAddresses(MPNode::NodeChild);
 
-                        /* Create new node with null address and virtual address set to our counter value */
-                        MPNode* newDataChildNodePt = pMesProt->createMPNode(QByteArray(getChildNodeSize(), 0), this, QByteArray(), newAddressesNeededCounter);
-                        newDataChildNodePt->setType(MPNode::NodeChild);
-                        newDataChildNodePt->setDataChildNodeData(imported_child_node->getNodeFlags(), imported_child_node->getDataChildNodeData());
-                        newDataChildNodePt->setMergeTagged();
+                                /* Next item */
+                                cur_matched_child_node_addr = matched_child_node->getNextChildDataAddress();
+                                cur_matched_child_node_addr_v = matched_child_node->getNextChildVirtualAddress();
 
-                        /* Add node to list */
-                        dataChildNodes.append(newDataChildNodePt);
-                        if (!prev_matched_child_node)
-                        {
-                            /* First node */
-                            dataNodes[j]->setStartChildAddress(QByteArray(), newAddressesNeededCounter);
+                                /* Delete current block */
+                                removeNodeFromList(dataChildNodes, matched_child_node);
+                                dataChildNodesIndex.remove(matched_child_node);
+                                importMergeStats.dataBlocksDropped++;
+                            }
                         }
                         else
                         {
-                            prev_matched_child_node->setNextChildDataAddress(QByteArray(), newAddressesNeededCounter);
+                            matched_child_node->setMergeTagged();
+                            importMergeStats.dataBlocksMatched++;
                         }
-
-                        /* Update prev matched child node */
-                        prev_matched_child_node = newDataChildNodePt;
                     }
+                }
 
-                    // Fetch next matched child if comparison is still ongoing
-                    if (data_match_ongoing)
+                // If we stopped matching the child nodes, add child node data
+                if (!data_match_ongoing)
+                {
+                    qDebug() << importedDataNodes[i]->getService() << " : appending child data in the mooltipass...";
+
+                    /* Increment new addresses counter */
+                    incrementNeededAddresses(MPNode::NodeChild);
+
+                    /* Create new node with null address and virtual address set to our counter value */
+                    MPNode* newDataChildNodePt = pMesProt->createMPNode(QByteArray(getChildNodeSize(), 0), this, QByteArray(), newAddressesNeededCounter);
+                    newDataChildNodePt->setType(MPNode::NodeChild);
+                    newDataChildNodePt->setDataChildNodeData(imported_child_node->getNodeFlags(), imported_child_node->getDataChildNodeData());
+                    newDataChildNodePt->setMergeTagged();
+
+                    /* Add node to list */
+                    appendNodeToList(dataChildNodes, newDataChildNodePt);
+                    dataChildNodesIndex.insert(newDataChildNodePt);
+                    importMergeStats.dataBlocksAdded++;
+                    if (!prev_matched_child_node)
+                    {
+                        /* First node */
+                        matchedNode->setStartChildAddress(QByteArray(), newAddressesNeededCounter);
+                    }
+                    else
                     {
-                        prev_matched_child_node = matched_child_node;
-                        matched_child_node->setMergeTagged();
-                        cur_matched_child_node_addr = matched_child_node->getNextChildDataAddress();
-                        cur_matched_child_node_addr_v = matched_child_node->getNextChildVirtualAddress();
+                        prev_matched_child_node->setNextChildDataAddress(QByteArray(), newAddressesNeededCounter);
                     }
 
-                    cur_import_child_node_addr = imported_child_node->getNextChildDataAddress();
-                    cur_import_child_node_addr_v = imported_child_node->getNextChildVirtualAddress();
+                    /* Update prev matched child node */
+                    prev_matched_child_node = newDataChildNodePt;
                 }
 
-                // Jump to next service node
-                break;
+                // Fetch next matched child if comparison is still ongoing
+                if (data_match_ongoing)
+                {
+                    prev_matched_child_node = matched_child_node;
+                    matched_child_node->setMergeTagged();
+                    cur_matched_child_node_addr = matched_child_node->getNextChildDataAddress();
+                    cur_matched_child_node_addr_v = matched_child_node->getNextChildVirtualAddress();
+                }
+
+                cur_import_child_node_addr = imported_child_node->getNextChildDataAddress();
+                cur_import_child_node_addr_v = imported_child_node->getNextChildVirtualAddress();
             }
         }
 
@@ -6088,7 +6198,9 @@ bool MPDevice::checkImportedDataNodes(const MessageHandlerCb &cb)
            newNodePt->setMergeTagged();
 
            /* Add node to list */
-           dataNodes.append(newNodePt);
+           appendNodeToList(dataNodes, newNodePt);
+           dataNodesByService.insert(qMakePair(newNodePt->getService(), newNodePt->getStartDataCtr()), newNodePt);
+           importMergeStats.dataParentsAdded++;
            if (!addOrphanParentToDB(newNodePt, true, false))
            {
                cleanImportedVars();
@@ -6104,7 +6216,7 @@ bool MPDevice::checkImportedDataNodes(const MessageHandlerCb &cb)
            while (curImportChildAddr != MPNode::EmptyAddress)
            {
                /* Find node in list */
-               MPNode* curImportChildPt = findNodeWithAddressInList(importedDataChildNodes, curImportChildAddr);
+               MPNode* curImportChildPt = importedDataChildNodesIndex.find(curImportChildAddr);
                encDataSize += MP_NODE_DATA_ENC_SIZE;
 
                if (!curImportChildPt)
@@ -6126,7 +6238,9 @@ bool MPDevice::checkImportedDataNodes(const MessageHandlerCb &cb)
                newDataChildNodePt->setMergeTagged();
 
                /* Add node to list */
-               dataChildNodes.append(newDataChildNodePt);
+               appendNodeToList(dataChildNodes, newDataChildNodePt);
+               dataChildNodesIndex.insert(newDataChildNodePt);
+               importMergeStats.dataBlocksAdded++;
                if (!prev_added_child_node)
                {
                    /* First node */
@@ -6149,6 +6263,37 @@ bool MPDevice::checkImportedDataNodes(const MessageHandlerCb &cb)
     return true;
 }
 
+void MPDevice::logImportMergeStats(bool noDelete)
+{
+    /* Nodes that weren't tagged while merging are the ones finishImportFileMerging removes */
+    int untaggedNodes = 0;
+    for (const NodeList *list : {&loginNodes, &loginChildNodes, &webAuthnLoginNodes,
+                                 &webAuthnLoginChildNodes, &dataNodes, &dataChildNodes})
+    {
+        for (const MPNode *node : *list)
+        {
+            if (!node->getMergeTagged())
+            {
+                untaggedNodes++;
+            }
+        }
+    }
+
+    const ImportMergeStats &stats = importMergeStats;
+    qInfo() << "Import merge:" << stats.parentsMatched << "services matched," << stats.parentsAdded << "added";
+    qInfo() << "Import merge:" << stats.childrenMatched << "credentials matched," << stats.childrenUpdated << "updated," << stats.childrenAdded << "added";
+    qInfo() << "Import merge:" << stats.dataParentsMatched << "data services matched," << stats.dataParentsAdded << "added";
+    qInfo() << "Import merge:" << stats.dataBlocksMatched << "data blocks matched," << stats.dataBlocksAdded << "added," << stats.dataBlocksDropped << "dropped";
+    if (noDelete)
+    {
+        qInfo() << "Import merge:" << untaggedNodes << "nodes not in the import file are kept";
+    }
+    else
+    {
+        qInfo() << "Import merge:" << untaggedNodes << "nodes not in the import file will be deleted";
+    }
+}
+
 bool MPDevice::finishImportFileMerging(QString &stringError, bool noDelete)
 {
     qInfo() << "Finishing Import File Merging...";
@@ -6213,7 +6358,7 @@ bool MPDevice::finishImportFileMerging(QString &stringError, bool noDelete)
                     }
 
                     /* Delete child */
-                    dataChildNodes.removeOne(curNode);
+                    removeNodeFromList(dataChildNodes, curNode);
                     nodeItem->removeChild(curNode);
                     delete(curNode);
                 }
@@ -6471,64 +6616,96 @@ void MPDevice::startIntegrityCheck(const std::function<void(bool success, int fr
         qInfo() << "Available blocks:" << diagTotalBlocks - diagFreeBlocks;
         qInfo() << "Available credentials:" << (diagTotalBlocks - diagFreeBlocks) / 2;
 
-        /* We finished loading the nodes in memory */
-        AsyncJobs* repairJobs = new AsyncJobs("Checking memory contents...", this);
+        /* Validate each address space on worker threads, the repair code only runs on errors */
+        AsyncJobs *repairJobs = new AsyncJobs("Checking memory contents...", this);
+        CustomJob *checkJob = new CustomJob;
+        checkJob->setWork([this, checkJob, repairJobs, cb]()
+        {
+            auto *watcher = new QFutureWatcher<int>(checkJob);
+            connect(watcher, &QFutureWatcherBase::finished, checkJob, [this, watcher, checkJob, repairJobs, cb]()
+            {
+                int nbErrors = 0;
+                for (int errors : watcher->future().results())
+                {
+                    nbErrors += errors;
+                }
+                if (nbErrors > 0)
+                {
+                    qWarning() << "Integrity check found" << nbErrors << "errors, running the repair pass";
+                }
+                repairLoadedNodes(repairJobs, nbErrors > 0, cb);
+                emit checkJob->done(QByteArray());
+            });
+            watcher->setFuture(QtConcurrent::mapped(snapshotNodeChains(), &NodeChainSnapshot::countErrors));
+        });
+        repairJobs->append(checkJob);
+
+        /* Run right after the flash read: no other job may touch the loaded nodes
+         * until the repair packets are generated */
+        jobsQueue.prepend(repairJobs);
+    });
+
+    connect(jobs, &AsyncJobs::failed, [this, cb](AsyncJob *failedJob)
+    {
+        Q_UNUSED(failedJob);
+        qCritical() << "Failed scanning the flash memory";
+        cb(false, diagFreeBlocks, diagTotalBlocks, "Couldn't scan the complete memory (Device Disconnected?)");
+    });
+
+    jobsQueue.enqueue(jobs);
+    runAndDequeueJobs();
+}
 
-        /* Let's corrupt the DB for fun */
-        //testCodeAgainstCleanDBChanges(repairJobs);
+void MPDevice::repairLoadedNodes(AsyncJobs *repairJobs, bool errorsFound, const std::function<void(bool success, int freeBlocks, int totalBlocks, QString errstr)> &cb)
+{
+    /* Let's corrupt the DB for fun */
+    //testCodeAgainstCleanDBChanges(repairJobs);
 
+    if (errorsFound)
+    {
         /* Check loaded nodes, set bool to repair */
         checkLoadedNodes(true, true, true);
 
         /* Just in case a new _recovered_ service was added, change virtual for real addresses */
         changeVirtualAddressesToFreeAddresses();
+    }
+    else
+    {
+        qInfo() << "Database check OK";
+    }
 
-        /* set clone change number to actual, to prevent change number changes on device */
-        credentialsDbChangeNumberClone = get_credentialsDbChangeNumber();
-        dataDbChangeNumberClone = get_dataDbChangeNumber();
-
-        /* Generate save packets */
-        bool packets_generated = generateSavePackets(repairJobs, true, true, [](QVariantMap){});
+    /* set clone change number to actual, to prevent change number changes on device */
+    credentialsDbChangeNumberClone = get_credentialsDbChangeNumber();
+    dataDbChangeNumberClone = get_dataDbChangeNumber();
 
-        /* Leave MMM */
-        repairJobs->append(new MPCommandJob(this, MPCmd::END_MEMORYMGMT, pMesProt->getDefaultFuncDone()));
+    /* Generate save packets */
+    bool packets_generated = generateSavePackets(repairJobs, true, true, [](QVariantMap){});
 
-        connect(repairJobs, &AsyncJobs::finished, [this, packets_generated, cb](const QByteArray &data)
-        {
-            Q_UNUSED(data);
+    /* Leave MMM */
+    repairJobs->append(new MPCommandJob(this, MPCmd::END_MEMORYMGMT, pMesProt->getDefaultFuncDone()));
 
-            if (packets_generated)
-            {
-                qInfo() << "Found and Corrected Errors in Database";
-                cb(true, diagFreeBlocks, diagTotalBlocks, "Errors Were Found And Corrected In The Database");
-            }
-            else
-            {
-                qInfo() << "Nothing to correct in DB";
-                cb(true, diagFreeBlocks, diagTotalBlocks, "Database Is Free Of Errors");
-            }
-        });
+    connect(repairJobs, &AsyncJobs::finished, [this, packets_generated, cb](const QByteArray &data)
+    {
+        Q_UNUSED(data);
 
-        connect(repairJobs, &AsyncJobs::failed, [this, cb](AsyncJob *failedJob)
+        if (packets_generated)
         {
-            Q_UNUSED(failedJob);
-            qCritical() << "Couldn't check memory contents";
-            cb(false, diagFreeBlocks, diagTotalBlocks, "Error While Correcting Database (Device Disconnected?)");
-        });
-
-        jobsQueue.enqueue(repairJobs);
-        runAndDequeueJobs();
+            qInfo() << "Found and Corrected Errors in Database";
+            cb(true, diagFreeBlocks, diagTotalBlocks, "Errors Were Found And Corrected In The Database");
+        }
+        else
+        {
+            qInfo() << "Nothing to correct in DB";
+            cb(true, diagFreeBlocks, diagTotalBlocks, "Database Is Free Of Errors");
+        }
     });
 
-    connect(jobs, &AsyncJobs::failed, [this, cb](AsyncJob *failedJob)
+    connect(repairJobs, &AsyncJobs::failed, [this, cb](AsyncJob *failedJob)
     {
         Q_UNUSED(failedJob);
-        qCritical() << "Failed scanning the flash memory";
-        cb(false, diagFreeBlocks, diagTotalBlocks, "Couldn't scan the complete memory (Device Disconnected?)");
+        qCritical() << "Couldn't check memory contents";
+        cb(false, diagFreeBlocks, diagTotalBlocks, "Error While Correcting Database (Device Disconnected?)");
     });
-
-    jobsQueue.enqueue(jobs);
-    runAndDequeueJobs();
 }
 
 void MPDevice::serviceExists(bool isDatanode, QString service, const QString &reqid,
@@ -6730,9 +6907,33 @@ void MPDevice::importFromCSV(const QJsonArray &creds, const MPDeviceProgressCb &
     runAndDequeueJobs();
 }
 
+void MPDevice::setMMCredentialsDelta(const QJsonArray &creds, const QJsonArray &deleted,
+                                     const MPDeviceProgressCb &cbProgress, MessageHandlerCb cb)
+{
+    QList<QByteArray> deletedAddrs;
+    for (const QJsonValue &addrValue : deleted)
+    {
+        QJsonArray addrArray = addrValue.toArray();
+        if (addrArray.size() != MPNode::EmptyAddress.size())
+        {
+            qCritical() << "Unknown JSON deleted credential format:" << addrValue;
+            cb(false, "Wrong JSON formated credential list");
+            return;
+        }
+
+        QByteArray nodeAddr;
+        for (qint32 j = 0; j < addrArray.size(); j++) { nodeAddr.append(addrArray[j].toInt()); }
+        deletedAddrs.append(nodeAddr);
+    }
+
+    qInfo() << "MMM Save:" << creds.size() << "credentials changed," << deletedAddrs.size() << "deleted";
+    setMMCredentials(creds, true, cbProgress, std::move(cb), false, &deletedAddrs);
+}
+
 void MPDevice::setMMCredentials(const QJsonArray &creds, bool noDelete,
                                 const MPDeviceProgressCb &cbProgress,
-                                MessageHandlerCb cb, bool isCsv /* = false */)
+                                MessageHandlerCb cb, bool isCsv /* = false */,
+                                const QList<QByteArray> *deletedAddrs /* = nullptr */)
 {
     newAddressesNeededCounter = 0;
     newAddressesReceivedCounter = 0;
@@ -6742,6 +6943,29 @@ void MPDevice::setMMCredentials(const QJsonArray &creds, bool noDelete,
 
     /// TODO: sanitize inputs (or not, as it is done at the mpnode.cpp level)
 
+    /* Index the login children by address and by parent once, instead of searching the lists for every credential */
+    NodeAddressIndex childNodesIndex = indexNodesByAddress(loginChildNodes);
+    QHash<QByteArray, MPNode*> parentByChildAddr;
+    for (MPNode* parentNode : loginNodes)
+    {
+        QByteArray curChildNodeAddr = parentNode->getStartChildAddress();
+        quint32 curChildNodeAddr_v = parentNode->getStartChildVirtualAddress();
+        while ((curChildNodeAddr != MPNode::EmptyAddress) || (curChildNodeAddr.isNull() && curChildNodeAddr_v != 0))
+        {
+            MPNode* curNode = childNodesIndex.find(curChildNodeAddr, curChildNodeAddr_v);
+            if (!curNode)
+            {
+                break;
+            }
+            if (!curChildNodeAddr.isNull())
+            {
+                parentByChildAddr.insert(curChildNodeAddr, parentNode);
+            }
+            curChildNodeAddr = curNode->getNextChildAddress();
+            curChildNodeAddr_v = curNode->getNextChildVirtualAddress();
+        }
+    }
+
     /* Look for deleted or changed nodes */
     for (qint32 i = 0; i < creds.size(); i++)
     {
@@ -6783,7 +7007,7 @@ void MPDevice::setMMCredentials(const QJsonArray &creds, bool noDelete,
             qDebug() << "MMM Save: tackling " << login << " for service " << service << " at address " << nodeAddr.toHex();
 
             /* Find node in our list */
-            MPNode* nodePtr = findNodeWithAddressInList(loginChildNodes, nodeAddr);
+            MPNode* nodePtr = childNodesIndex.find(nodeAddr);
 
             /* If not a new node, look for parent Node */
             MPNode* parentNodePtr = nullptr;
@@ -6791,7 +7015,7 @@ void MPDevice::setMMCredentials(const QJsonArray &creds, bool noDelete,
             if (!nodeAddr.isNull())
             {
                 /* Find parent node that has as a children the currently investigated one */
-                parentNodePtr = findCredParentNodeGivenChildNodeAddr(nodeAddr, 0);
+                parentNodePtr = parentByChildAddr.value(nodeAddr);
                 if (!parentNodePtr)
                 {
                     qCritical() << "Error in our local DB (algo PB?)";
@@ -6827,7 +7051,8 @@ void MPDevice::setMMCredentials(const QJsonArray &creds, bool noDelete,
                 /* Create new node with null address and virtual address set to our counter value */
                 MPNode* newNodePt = pMesProt->createMPNode(QByteArray(getChildNodeSize(), 0), this, QByteArray(), newAddressesNeededCounter);
                 newNodePt->setType(MPNode::NodeChild);
-                loginChildNodes.append(newNodePt);
+                appendNodeToList(loginChildNodes, newNodePt);
+                childNodesIndex.insert(newNodePt);
                 newNodePt->setNotDeletedTagged();
                 newNodePt->setLogin(login);
                 newNodePt->setDescription(description);
@@ -6893,6 +7118,7 @@ void MPDevice::setMMCredentials(const QJsonArray &creds, bool noDelete,
                     bleImpl->setNodeKeyAfterPwd(nodePtr, keyAfterPwd);
                 }
                 addChildToDB(parentPtr, nodePtr);
+                parentByChildAddr.insert(nodeAddr, parentPtr);
 
                 /* Check for changed password */
                 if (!password.isEmpty())
@@ -6962,7 +7188,7 @@ void MPDevice::setMMCredentials(const QJsonArray &creds, bool noDelete,
                     qDebug() << "Detected login change";
 
                     /* Look for parent Node */
-                    MPNode* parentNodePtr = findCredParentNodeGivenChildNodeAddr(nodePtr->getAddress(), nodePtr->getVirtualAddress());
+                    MPNode* parentNodePtr = parentByChildAddr.value(nodePtr->getAddress());
                     if (!parentNodePtr)
                     {
                         qCritical() << "Couldn't find parent node" << qjobject["service"].toString() << " for login " << qjobject["login"].toString() << " at address " << nodeAddr.toHex();
@@ -6975,8 +7201,10 @@ void MPDevice::setMMCredentials(const QJsonArray &creds, bool noDelete,
                     MPNode* newNode = pMesProt->createMPNode(nodePtr->getNodeData(), this, nodePtr->getAddress(), nodePtr->getVirtualAddress());
                     newNode->setLogin(login);
                     newNode->setNotDeletedTagged();
-                    loginChildNodes.append(newNode);
+                    appendNodeToList(loginChildNodes, newNode);
+                    childNodesIndex.remove(nodePtr);
                     removeChildFromDB(parentNodePtr, nodePtr, false, true);
+                    childNodesIndex.insert(newNode);
                     addChildToDB(parentNodePtr, newNode);
                     packet_send_needed = true;
 
@@ -7005,48 +7233,73 @@ void MPDevice::setMMCredentials(const QJsonArray &creds, bool noDelete,
         }
     }
 
-    /* Browse through the memory contents to find not nonDeleted nodes */
-    QListIterator<MPNode*> i(loginNodes);
-    while (i.hasNext())
+    /* Delta mode: only delete the credentials we were told about */
+    if (deletedAddrs)
     {
-        MPNode* nodeItem = i.next();
-
-        /* No need to check for notdeleted tagged for parent, as it'll automatically be removed if it doesn't have any child */
-        QByteArray curChildNodeAddr = nodeItem->getStartChildAddress();
-        quint32 curChildNodeAddr_v = nodeItem->getStartChildVirtualAddress();
-
-        /* Special case: no child */
-        if ((curChildNodeAddr == MPNode::EmptyAddress) || (curChildNodeAddr.isNull() && curChildNodeAddr_v == 0))
+        for (const QByteArray &nodeAddr : *deletedAddrs)
         {
-            /* Remove parent */
-            removeEmptyParentFromDB(nodeItem, false);
-            packet_send_needed = true;
-        }
-
-        /* Check every children */
-        while ((curChildNodeAddr != MPNode::EmptyAddress) || (curChildNodeAddr.isNull() && curChildNodeAddr_v != 0))
-        {
-            MPNode* curNode = findNodeWithAddressInList(loginChildNodes, curChildNodeAddr, curChildNodeAddr_v);
-
-            /* Safety checks */
-            if (!curNode)
+            MPNode* nodePtr = nodeAddr.isNull() ? nullptr : childNodesIndex.find(nodeAddr);
+            MPNode* parentNodePtr = parentByChildAddr.value(nodeAddr);
+            if (!nodePtr || !parentNodePtr)
             {
-                qCritical() << "Couldn't find child node in list (corrupted DB?)";
-                cb(false, "Database error: please run integrity check");
+                qCritical() << "Couldn't find deleted credential at address" << nodeAddr.toHex();
+                cb(false, "Moolticute Internal Error (SMMC#5)");
                 exitMemMgmtMode(true);
                 return;
             }
 
-            /* Next item */
-            curChildNodeAddr = curNode->getNextChildAddress();
-            curChildNodeAddr_v = curNode->getNextChildVirtualAddress();
+            childNodesIndex.remove(nodePtr);
+            parentByChildAddr.remove(nodeAddr);
+            removeChildFromDB(parentNodePtr, nodePtr, true, true);
+            packet_send_needed = true;
+        }
+    }
+    else
+    {
+        /* Browse through the memory contents to find not nonDeleted nodes */
+        QListIterator<MPNode*> i(loginNodes);
+        while (i.hasNext())
+        {
+            MPNode* nodeItem = i.next();
 
-            /* Marked for deletion? */
-            if (!noDelete && !curNode->getNotDeletedTagged())
+            /* No need to check for notdeleted tagged for parent, as it'll automatically be removed if it doesn't have any child */
+            QByteArray curChildNodeAddr = nodeItem->getStartChildAddress();
+            quint32 curChildNodeAddr_v = nodeItem->getStartChildVirtualAddress();
+
+            /* Special case: no child */
+            if ((curChildNodeAddr == MPNode::EmptyAddress) || (curChildNodeAddr.isNull() && curChildNodeAddr_v == 0))
             {
-                removeChildFromDB(nodeItem, curNode, true, true);
+                /* Remove parent */
+                removeEmptyParentFromDB(nodeItem, false);
                 packet_send_needed = true;
             }
+
+            /* Check every children */
+            while ((curChildNodeAddr != MPNode::EmptyAddress) || (curChildNodeAddr.isNull() && curChildNodeAddr_v != 0))
+            {
+                MPNode* curNode = childNodesIndex.find(curChildNodeAddr, curChildNodeAddr_v);
+
+                /* Safety checks */
+                if (!curNode)
+                {
+                    qCritical() << "Couldn't find child node in list (corrupted DB?)";
+                    cb(false, "Database error: please run integrity check");
+                    exitMemMgmtMode(true);
+                    return;
+                }
+
+                /* Next item */
+                curChildNodeAddr = curNode->getNextChildAddress();
+                curChildNodeAddr_v = curNode->getNextChildVirtualAddress();
+
+                /* Marked for deletion? */
+                if (!noDelete && !curNode->getNotDeletedTagged())
+                {
+                    childNodesIndex.remove(curNode);
+                    removeChildFromDB(nodeItem, curNode, true, true);
+                    packet_send_needed = true;
+                }
+            }
         }
     }
 
@@ -7082,8 +7335,11 @@ void MPDevice::setMMCredentials(const QJsonArray &creds, bool noDelete,
 
     emit dbChangeNumbersChanged(get_credentialsDbChangeNumber(), get_dataDbChangeNumber());
 
-    /* Out of pure coding laziness, ask free addresses even if we don't need them */
-    loadFreeAddresses(jobs, MPNode::EmptyAddress, false, cbProgress);
+    /* Only ask free addresses when new nodes were added, saves a device round trip for simple edits */
+    if (newAddressesNeededCounter > 0)
+    {
+        loadFreeAddresses(jobs, MPNode::EmptyAddress, false, cbProgress);
+    }
 
     connect(jobs, &AsyncJobs::finished, [this, cb, cbProgress, isCsv, onlyChangePwd](const QByteArray &)
     {
@@ -7324,8 +7580,29 @@ void MPDevice::exportDatabase(const QString &encryption, std::function<void(bool
         }
         else
         {
-            /* Generate export file */
-            cb(true, "Export File Generated!", generateExportFileData(encryption));
+            /* Generate export file, the payload is encoded and encrypted off the main thread */
+            QString enc = encryption;
+            if (isBLE() && enc == Common::SIMPLE_CRYPT)
+            {
+                // For BLE using the new encryption
+                enc = Common::SIMPLE_CRYPT_V2;
+            }
+            const QJsonArray payloadArray = generateExportPayload();
+            const quint64 key = getUInt64EncryptionKey(enc);
+            const quint8 credChangeNumber = static_cast<quint8>(get_credentialsDbChangeNumber());
+            const quint8 dataChangeNumber = static_cast<quint8>(get_dataDbChangeNumber());
+
+            auto future = QtConcurrent::run(&jsonPool, [payloadArray, enc, key, credChangeNumber, dataChangeNumber]()
+            {
+                return encodeExportFile(payloadArray, enc, key, credChangeNumber, dataChangeNumber);
+            });
+            auto *watcher = new QFutureWatcher<QByteArray>(this);
+            connect(watcher, &QFutureWatcherBase::finished, this, [watcher, cb]()
+            {
+                watcher->deleteLater();
+                cb(true, "Export File Generated!", watcher->result());
+            });
+            watcher->setFuture(future);
         }
     });
 
@@ -7344,14 +7621,36 @@ void MPDevice::importDatabase(const QByteArray &fileData, bool noDelete,
                               MessageHandlerCb cb,
                               const MPDeviceProgressCb &cbProgress)
 {
-    QString errorString;
+    /* Parse and decrypt the file off the main thread, then load it */
+    const quint64 key = getUInt64EncryptionKey();
+    const quint64 keyOld = getUInt64EncryptionKeyOld();
+    auto future = QtConcurrent::run(&jsonPool, [fileData, key, keyOld]()
+    {
+        QString errorString;
+        QJsonArray dataArray = decodeExportFile(fileData, key, keyOld, errorString);
+        return qMakePair(dataArray, errorString);
+    });
+
+    auto *watcher = new QFutureWatcher<QPair<QJsonArray, QString>>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, noDelete, cb, cbProgress]()
+    {
+        watcher->deleteLater();
+        const auto decoded = watcher->result();
+        importDecodedDatabase(decoded.first, decoded.second, noDelete, cb, cbProgress);
+    });
+    watcher->setFuture(future);
+}
 
+void MPDevice::importDecodedDatabase(const QJsonArray &dataArray, QString errorString, bool noDelete,
+                                     MessageHandlerCb cb,
+                                     const MPDeviceProgressCb &cbProgress)
+{
     /* Reset temp vars */
     newAddressesNeededCounter = 0;
     newAddressesReceivedCounter = 0;
 
     /* Try to read the export file */
-    if (readExportFile(fileData, errorString))
+    if (readExportFile(dataArray, errorString))
     {
         /// We are here because the card is known by the export file and the export file is valid
 
@@ -7401,6 +7700,232 @@ void MPDevice::importDatabase(const QByteArray &fileData, bool noDelete,
     }
 }
 
+NodeListSnapshot::~NodeListSnapshot()
+{
+    //The last reference may be dropped by a worker thread,
+    //nodes are deleted in the thread that owns them
+    for (MPNode *node : loginNodes)
+        node->deleteLater();
+    for (MPNode *node : dataNodes)
+        node->deleteLater();
+}
+
+QJsonObject NodeListSnapshot::toJson() const
+{
+    QJsonArray logins;
+    for (const MPNode *n : loginNodes)
+    {
+        logins.append(n->toJson());
+    }
+
+    QJsonArray datas;
+    for (const MPNode *n : dataNodes)
+    {
+        datas.append(n->toJson());
+    }
+
+    QJsonObject jdata;
+    jdata["login_nodes"] = logins;
+    jdata["data_nodes"] = datas;
+    return jdata;
+}
+
+static quint64 linkKey(const MPNode::Link &link)
+{
+    return link.isVirtual ? (Q_UINT64_C(1) << 32) | link.virtualAddress : link.address;
+}
+
+int NodeChainSnapshot::countErrors() const
+{
+    /* Runs on the worker pool: only count, the repair pass logs the details */
+    int errors = 0;
+    QHash<quint64, int> parentIndex;
+    QHash<quint64, int> childIndex;
+    parentIndex.reserve(parents.size());
+    childIndex.reserve(children.size());
+    for (int i = 0; i < parents.size(); ++i)
+    {
+        parentIndex.insert(linkKey(parents[i].address), i);
+    }
+    for (int i = 0; i < children.size(); ++i)
+    {
+        childIndex.insert(linkKey(children[i].address), i);
+    }
+
+    /* Same walk as tagPointedNodes, without touching the nodes */
+    QVector<bool> parentTagged(parents.size(), false);
+    QVector<bool> childTagged(children.size(), false);
+    MPNode::Link parentLink = start;
+    int prevParent = -1;
+    while (!parentLink.isEmpty())
+    {
+        const int p = parentIndex.value(linkKey(parentLink), -1);
+        if (p < 0 || parentTagged[p])
+        {
+            ++errors;
+            break;
+        }
+
+        const bool prevOk = prevParent < 0 ? parents[p].previous.isEmpty() :
+                                             parents[p].previous == parents[prevParent].address;
+        if (!prevOk)
+        {
+            ++errors;
+        }
+        parentTagged[p] = true;
+
+        MPNode::Link childLink = parents[p].startChild;
+        int prevChild = -1;
+        while (!childLink.isEmpty())
+        {
+            const int c = childIndex.value(linkKey(childLink), -1);
+            if (c < 0 || childTagged[c])
+            {
+                ++errors;
+                break;
+            }
+
+            /* Data children do not have a previous address */
+            if (!isData)
+            {
+                const MPNode::Link &previous = children[c].previous;
+                const bool prevOk = prevChild < 0 ? previous.isEmpty() || (previous.isVirtual && 0 == previous.virtualAddress) :
+                                                    previous == children[prevChild].address;
+                if (!prevOk)
+                {
+                    ++errors;
+                }
+            }
+            childTagged[c] = true;
+            prevChild = c;
+            childLink = children[c].next;
+        }
+
+        prevParent = p;
+        parentLink = parents[p].next;
+    }
+
+    /* Orphans */
+    const int orphanParents = parentTagged.count(false);
+    const int orphanChildren = childTagged.count(false);
+    errors += orphanParents + orphanChildren;
+
+    /* Favorites must point to a child of the given parent */
+    for (const auto &fav : favorites)
+    {
+        if (fav.first.isEmpty())
+        {
+            continue;
+        }
+
+        bool found = false;
+        const int p = parentIndex.value(linkKey(fav.first), -1);
+        if (p >= 0)
+        {
+            MPNode::Link childLink = parents[p].startChild;
+            for (int steps = 0; !found && !childLink.isEmpty() && steps < children.size(); ++steps)
+            {
+                const int c = childIndex.value(linkKey(childLink), -1);
+                if (c < 0)
+                {
+                    break;
+                }
+                found = children[c].address == fav.second;
+                childLink = children[c].next;
+            }
+        }
+
+        if (!found)
+        {
+            ++errors;
+        }
+    }
+
+    return errors;
+}
+
+MPNode *MPDevice::snapshotNode(const MPNode *node)
+{
+    MPNode *copy = pMesProt->createMPNode(this, node->getAddress(), node->getVirtualAddress());
+    copy->shareData(*node);
+    copy->setFavoriteProperty(node->getFavoriteProperty());
+    copy->setParent(nullptr);
+    return copy;
+}
+
+std::shared_ptr<NodeListSnapshot> MPDevice::snapshotMemMgmtNodes()
+{
+    auto snapshot = std::make_shared<NodeListSnapshot>();
+    for (MPNode *n : loginNodes)
+    {
+        MPNode *copy = snapshotNode(n);
+        for (MPNode *child : n->getChildNodes())
+            copy->appendChild(snapshotNode(child));
+        snapshot->loginNodes.append(copy);
+    }
+    for (MPNode *n : dataNodes)
+    {
+        MPNode *copy = snapshotNode(n);
+        for (MPNode *child : n->getChildDataNodes())
+            copy->appendChildData(snapshotNode(child));
+        snapshot->dataNodes.append(copy);
+    }
+    return snapshot;
+}
+
+QVector<NodeChainSnapshot> MPDevice::snapshotNodeChains() const
+{
+    auto snapshotParents = [](NodeChainSnapshot &chain, const NodeList &nodes)
+    {
+        chain.parents.reserve(nodes.size());
+        for (const MPNode *n : nodes)
+        {
+            chain.parents.append({n->getAddressLink(), n->getPreviousParentLink(),
+                                  n->getNextParentLink(), n->getStartChildLink()});
+        }
+    };
+    auto snapshotChildren = [](NodeChainSnapshot &chain, const NodeList &nodes)
+    {
+        chain.children.reserve(nodes.size());
+        for (const MPNode *n : nodes)
+        {
+            chain.children.append({n->getAddressLink(), n->getPreviousChildLink(),
+                                   chain.isData ? n->getNextChildDataLink() : n->getNextChildLink()});
+        }
+    };
+
+    QVector<NodeChainSnapshot> chains(isBLE() ? 3 : 2);
+
+    NodeChainSnapshot &creds = chains[0];
+    creds.name = "credentials";
+    creds.start = MPNode::Link::fromAddress(startNode[Common::CRED_ADDR_IDX], virtualStartNode[Common::CRED_ADDR_IDX]);
+    snapshotParents(creds, loginNodes);
+    snapshotChildren(creds, loginChildNodes);
+    for (const QByteArray &fav : favoritesAddrs)
+    {
+        creds.favorites.append(qMakePair(MPNode::Link::fromAddress(fav.mid(0, 2)),
+                                         MPNode::Link::fromAddress(fav.mid(2, 2))));
+    }
+
+    NodeChainSnapshot &data = chains[1];
+    data.name = "data";
+    data.isData = true;
+    data.start = MPNode::Link::fromAddress(startDataNode, virtualDataStartNode);
+    snapshotParents(data, dataNodes);
+    snapshotChildren(data, dataChildNodes);
+
+    if (isBLE())
+    {
+        NodeChainSnapshot &webauthn = chains[2];
+        webauthn.name = "webauthn";
+        webauthn.start = MPNode::Link::fromAddress(startNode[Common::WEBAUTHN_ADDR_IDX], virtualStartNode[Common::WEBAUTHN_ADDR_IDX]);
+        snapshotParents(webauthn, webAuthnLoginNodes);
+        snapshotChildren(webauthn, webAuthnLoginChildNodes);
+    }
+
+    return chains;
+}
+
 QList<QVariantMap> MPDevice::getFilesCache()
 {
     return filesCache.load();
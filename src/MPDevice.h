@@ -20,6 +20,7 @@
 #define MPDEVICE_H
 
 #include <QObject>
+#include <QThreadPool>
 #include "Common.h"
 #include "MooltipassCmds.h"
 #include "QtHelper.h"
@@ -46,6 +47,61 @@ using MessageHandlerCbData = std::function<void(bool success, QString errstr, QB
 class MPDeviceBleImpl;
 class IMessageProtocol;
 
+/**
+ * @brief The NodeListSnapshot struct
+ * Read only copy of the memory management node lists, the node data
+ * is implicitly shared with the device nodes. It is serialized on a
+ * worker thread while the device keeps editing its own lists.
+ */
+struct NodeListSnapshot
+{
+    NodeListSnapshot() = default;
+    NodeListSnapshot(const NodeListSnapshot &) = delete;
+    NodeListSnapshot &operator=(const NodeListSnapshot &) = delete;
+    ~NodeListSnapshot();
+
+    QJsonObject toJson() const;
+
+    NodeList loginNodes;
+    NodeList dataNodes;
+};
+
+/**
+ * @brief The NodeChainSnapshot struct
+ * Links of the nodes of one address space (credentials, webauthn or data)
+ * copied out of the device lists. The integrity check validates the chains
+ * on worker threads and only runs the serial repair code on errors.
+ */
+struct NodeChainSnapshot
+{
+    struct ParentLinks
+    {
+        MPNode::Link address;
+        MPNode::Link previous;
+        MPNode::Link next;
+        MPNode::Link startChild;
+    };
+
+    struct ChildLinks
+    {
+        MPNode::Link address;
+        MPNode::Link previous;
+        MPNode::Link next;
+    };
+
+    //Returns the number of errors tagPointedNodes, the orphan scan
+    //and the favorites check would report for this address space
+    int countErrors() const;
+
+    QString name;
+    bool isData = false;
+    MPNode::Link start;
+    QVector<ParentLinks> parents;
+    QVector<ChildLinks> children;
+    //Parent and child links of the favorites, credentials only
+    QVector<QPair<MPNode::Link, MPNode::Link>> favorites;
+};
+
 class MPCommand
 {
 public:
@@ -53,16 +109,24 @@ public:
     MPCommandCb cb;
     bool running = false;
 
-    QTimer *timerTimeout = nullptr;
+    // Response timeout in ms, 0 when the command has no timeout (BLE)
+    int timeout = 0;
     int retry = CMD_MAX_RETRY;
     int retries_done = 0;
     qint64 sent_ts = 0;
 
+    // For DeviceMetrics
+    qint64 metrics_ts = 0;
+    int packets_in = 0;
+    int bytes_in = 0;
+    bool metrics_recorded = false;
+
     bool checkReturn = true;
 
     // For BLE
     QByteArray response;
     int responseSize = 0;
+    int responseFill = 0;
 };
 
 class MPDevice: public QObject
@@ -161,8 +225,12 @@ public:
                           MessageHandlerCb cb);
 
     //Set full list of credentials in MMM
+    //When deletedAddrs is set, only the credentials at these addresses are deleted
     void setMMCredentials(const QJsonArray &creds, bool noDelete, const MPDeviceProgressCb &cbProgress,
-                          MessageHandlerCb cb, bool isCsv = false);
+                          MessageHandlerCb cb, bool isCsv = false, const QList<QByteArray> *deletedAddrs = nullptr);
+    //Set only modified and added credentials in MMM, and delete the ones at the given addresses
+    void setMMCredentialsDelta(const QJsonArray &creds, const QJsonArray &deleted, const MPDeviceProgressCb &cbProgress,
+                               MessageHandlerCb cb);
 
     //Export database
     void exportDatabase(const QString &encryption, std::function<void(bool success, QString errstr, QByteArray fileData)> cb,
@@ -192,6 +260,12 @@ public:
     //After successfull mem mgmt mode, clients can query data
     NodeList &getLoginNodes() { return loginNodes; }
     NodeList &getDataNodes() { return dataNodes; }
+    std::shared_ptr<NodeListSnapshot> snapshotMemMgmtNodes();
+
+    //Large JSON encoding/decoding (MMM data, export and import files) runs
+    //there, so the device I/O and websocket loop does not stall on it.
+    //The device waits for these jobs before being destroyed.
+    QThreadPool *serializationPool() { return &jsonPool; }
 
     //true if device is a mini
     inline bool isMini() const { return DeviceType::MINI == deviceType; }
@@ -257,6 +331,7 @@ private slots:
     void newDataRead(const QByteArray &data);
     void commandFailed();
     void sendDataDequeue(); //execute commands from the command queue
+    void commandTimerExpired(); //timeout or delayed resend of the running command
     void runAndDequeueJobs(); //execute AsyncJobs from the jobs queues
     void resetFlipBit();
 
@@ -299,11 +374,24 @@ private:
     // Functions added by mathieu for MMM
     void memMgmtModeReadFlash(AsyncJobs *jobs, bool fullScan, const MPDeviceProgressCb &cbProgress, bool getCreds, bool getData, bool getDataChilds);
     MPNode *findNodeWithAddressInList(NodeList list, const QByteArray &address, const quint32 virt_addr = 0);
+    // Address lookup table of a node list, same matching as findNodeWithAddressInList
+    // Keyed on the address values, lookups do not allocate
+    struct NodeAddressIndex
+    {
+        QHash<quint16, MPNode *> nodes;
+        QHash<quint32, MPNode *> virtualNodes;
+        MPNode *find(const QByteArray &address, const quint32 virt_addr = 0) const;
+        MPNode *find(const MPNode::Link &link) const;
+        void insert(MPNode *node);
+        void remove(MPNode *node);
+    };
+    static NodeAddressIndex indexNodesByAddress(const NodeList &list);
     MPNode* findCredParentNodeGivenChildNodeAddr(const QByteArray &address, const quint32 virt_addr);
     void addWriteNodePacketToJob(AsyncJobs *jobs, const QByteArray &address, const QByteArray &data, std::function<void(void)> writeCallback);
     void startImportFileMerging(const MPDeviceProgressCb &progressCb, MessageHandlerCb cb, bool noDelete);
     bool checkImportedLoginNodes(const MessageHandlerCb &cb, Common::AddressType addrType);
     bool checkImportedDataNodes(const MessageHandlerCb &cb);
+    void logImportMergeStats(bool noDelete);
     void loadFreeAddresses(AsyncJobs *jobs, const QByteArray &addressFrom, bool discardFirstAddr, const MPDeviceProgressCb &cbProgress);
     void incrementNeededAddresses(MPNode::NodeType type);
     MPNode *findNodeWithAddressWithGivenParentInList(NodeList list,  MPNode *parent, const QByteArray &address, const quint32 virt_addr);
@@ -324,19 +412,27 @@ private:
     // Functions added by mathieu for MMM : checks & repairs
     bool addOrphanParentToDB(MPNode *parentNodePt, bool isDataParent, bool addPossibleChildren, Common::AddressType addrType = Common::CRED_ADDR_IDX);
     bool checkLoadedNodes(bool checkCredentials, bool checkData, bool repairAllowed);
+    QVector<NodeChainSnapshot> snapshotNodeChains() const;
+    void repairLoadedNodes(AsyncJobs *repairJobs, bool errorsFound, const std::function<void(bool success, int freeBlocks, int totalBlocks, QString errstr)> &cb);
     void checkLoadedLoginNodes(quint32 &parentNum, quint32 &childNum, bool repairAllowed, Common::AddressType addrType);
     bool tagPointedNodes(bool tagCredentials, bool tagData, bool repairAllowed, Common::AddressType addrType = Common::CRED_ADDR_IDX);
     bool addOrphanParentChildsToDB(MPNode *parentNodePt, bool isDataParent, Common::AddressType addrType = Common::CRED_ADDR_IDX);
     bool removeEmptyParentFromDB(MPNode* parentNodePt, bool isDataParent, Common::AddressType addrType = Common::CRED_ADDR_IDX);
-    bool readExportFile(const QByteArray &fileData, QString &errorString);
-    void readExportNodes(QJsonArray &&nodes, ExportPayloadData id, bool fromMiniToBle = false);
+    bool readExportFile(const QJsonArray &dataArray, QString &errorString);
+    void importDecodedDatabase(const QJsonArray &dataArray, QString errorString, bool noDelete,
+                               MessageHandlerCb cb, const MPDeviceProgressCb &cbProgress);
+    bool readExportNodes(QJsonArray &&nodes, ExportPayloadData id, bool fromMiniToBle = false);
     bool readExportPayload(QJsonArray dataArray, QString &errorString);
     bool removeChildFromDB(MPNode* parentNodePt, MPNode* childNodePt, bool deleteEmptyParent, bool deleteFromList, Common::AddressType addrType = Common::CRED_ADDR_IDX);
     bool addChildToDB(MPNode* parentNodePt, MPNode* childNodePt, Common::AddressType addrType = Common::CRED_ADDR_IDX);
     bool deleteDataParentChilds(MPNode *parentNodePt);
     MPNode* addNewServiceToDB(const QString &service, Common::AddressType addrType = Common::CRED_ADDR_IDX);
     bool addOrphanChildToDB(MPNode* childNodePt, Common::AddressType addrType = Common::CRED_ADDR_IDX);
-    QByteArray generateExportFileData(const QString &encryption = "none");
+    QJsonArray generateExportPayload();
+    static QByteArray encodeExportFile(const QJsonArray &payloadArray, const QString &encryption, quint64 key,
+                                       quint8 credentialsDbChangeNumber, quint8 dataDbChangeNumber);
+    static QJsonArray decodeExportFile(const QByteArray &fileData, quint64 key, quint64 keyOld, QString &errorString);
+    MPNode *snapshotNode(const MPNode *node);
     void cleanImportedVars(void);
     void cleanMMMVars(void);
 
@@ -345,8 +441,12 @@ private:
 
     // Generate save packets
     bool generateSavePackets(AsyncJobs *jobs, bool tackleCreds, bool tackleData, const MPDeviceProgressCb &cbProgress);
-    bool checkModifiedSavePacketNodes(AsyncJobs *jobs, std::function<void()> writeCb, Common::AddressType addrType);
-    bool checkRemovedSavePacketNodes(AsyncJobs *jobs, std::function<void()> writeCb, Common::AddressType addrType);
+    bool checkModifiedSavePacketNodes(AsyncJobs *jobs, std::function<void()> writeCb, bool dataNodesPass);
+    bool checkRemovedSavePacketNodes(AsyncJobs *jobs, std::function<void()> writeCb, bool dataNodesPass);
+
+    // Node list edits in MMM, recorded in the change journal
+    void appendNodeToList(NodeList &list, MPNode *node);
+    void removeNodeFromList(NodeList &list, MPNode *node);
 
     QByteArray getFreeAddress(quint32 virtualAddr);
     // once we fetched free addresses, this function is called
@@ -358,14 +458,18 @@ private:
     quint64 getUInt64EncryptionKey(const QString &encryption);
     quint64 getUInt64EncryptionKey();
     quint64 getUInt64EncryptionKeyOld();
-    QString encryptSimpleCrypt(const QByteArray &data, const QString &encryption);
-    QByteArray decryptSimpleCrypt(const QString &payload, const QString &encryption);
+    static QString encryptSimpleCrypt(const QByteArray &data, quint64 key);
+    static QByteArray decryptSimpleCrypt(const QString &payload, quint64 key);
 
     // Last page scanned
     quint16 lastFlashPageScanned = 0;
 
-    //timer that asks status
+    //timer that asks status, its interval is reset to STATUS_STARTING_DELAY
+    //when the status changes and doubles up to STATUS_MAX_DELAY while it does
+    //not. On an idle Mini a lock or unlock can take up to STATUS_MAX_DELAY
+    //to be reported, instead of STATUS_STARTING_DELAY with a fixed interval
     QTimer *statusTimer = nullptr;
+    void resetStatusPolling();
     QTimer *setDateTimer = nullptr;
 
     //local vars for performance diagnostics
@@ -378,6 +482,16 @@ private:
     //command queue
     QQueue<MPCommand> commandQueue;
 
+    //Only the head of commandQueue is ever waiting for the device,
+    //so a single timer handles its timeout, retries and delayed resends
+    QTimer *commandTimer = nullptr;
+    bool commandResendPending = false;
+
+    QThreadPool jsonPool;
+    void startCommandTimeout();
+    void stopCommandTimer();
+    void recordCommandMetrics(MPCommand &cmd, bool timedOut);
+
     //passwords we need to change after leaving mmm
     QList<QStringList> mmmPasswordChangeArray;
     struct ChangeElem
@@ -425,6 +539,7 @@ private:
     NodeList loginChildNodesClone;    //list of all parent nodes for credentials
     NodeList dataNodesClone;          //list of all parent nodes for data nodes
     NodeList dataChildNodesClone;     //list of all parent nodes for data nodes
+    MPNode::ChangeJournal nodeChangeJournal;   //changes made to the nodes above in MMM
 
     // Imported values
     bool isMooltiAppImportFile;
@@ -445,6 +560,22 @@ private:
     NodeList importedWebauthnLoginChildNodes;    //list of all parent nodes for credentials
     QMap<ExportPayloadData, NodeList*> importNodeMap;
 
+    // What the import file merge is about to change on the device
+    struct ImportMergeStats
+    {
+        int parentsMatched = 0;
+        int parentsAdded = 0;
+        int childrenMatched = 0;
+        int childrenUpdated = 0;
+        int childrenAdded = 0;
+        int dataParentsMatched = 0;
+        int dataParentsAdded = 0;
+        int dataBlocksMatched = 0;
+        int dataBlocksAdded = 0;
+        int dataBlocksDropped = 0;
+    };
+    ImportMergeStats importMergeStats;
+
     //WebAuthn datas
     NodeList webAuthnLoginNodes;
     NodeList webAuthnLoginNodesClone;
@@ -488,6 +619,7 @@ protected:
     static constexpr int RESET_SEND_DELAY = 800;
     static constexpr int INIT_STARTING_DELAY = RESET_SEND_DELAY + 150;
     static constexpr int STATUS_STARTING_DELAY = RESET_SEND_DELAY + 500;
+    static constexpr int STATUS_MAX_DELAY = STATUS_STARTING_DELAY * 4;
     static constexpr int CATEGORY_FETCH_DELAY = 5000;
     static constexpr int SET_DATE_INTERVAL = 4096*1000;
 };
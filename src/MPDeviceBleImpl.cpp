@@ -5,6 +5,7 @@
 #include "AppDaemon.h"
 #include "DeviceSettingsBLE.h"
 #include "Base32.h"
+#include <QThread>
 
 int MPDeviceBleImpl::s_LangNum = 0;
 int MPDeviceBleImpl::s_LayoutNum = 0;
@@ -14,6 +15,10 @@ MPDeviceBleImpl::MPDeviceBleImpl(MessageProtocolBLE* mesProt, MPDevice *dev):
     mpDev(dev),
     freeAddressProv(mesProt, dev)
 {
+    m_longMessageTimer.setSingleShot(true);
+    m_longMessageTimer.setInterval(LONG_MESSAGE_TIMEOUT_MS);
+    connect(&m_longMessageTimer, &QTimer::timeout, this, &MPDeviceBleImpl::handleLongMessageTimeout);
+
     m_noBundleCommands = {
         MPCmd::PING,
         MPCmd::MOOLTIPASS_STATUS,
@@ -26,6 +31,11 @@ MPDeviceBleImpl::MPDeviceBleImpl(MessageProtocolBLE* mesProt, MPDevice *dev):
         MPCmd::SET_DATE};
 }
 
+MPDeviceBleImpl::~MPDeviceBleImpl()
+{
+    stopFetchDataWriter();
+}
+
 bool MPDeviceBleImpl::isFirstPacket(const QByteArray &data)
 {
     quint8 actPacket = (data[1] & 0xF0) >> 4;
@@ -63,6 +73,8 @@ void MPDeviceBleImpl::getPlatInfo()
         mpDev->set_flashMbSize(memorySize);
         const auto bundleVersion = bleProt->toIntFromLittleEndian(static_cast<quint8>(response[14]), static_cast<quint8>(response[15]));
         set_bundleVersion(bundleVersion);
+        // Language tables only change with the bundle, serve them without asking the device
+        loadCachedLanguages();
     });
 
     mpDev->enqueueAndRunJob(jobs);
@@ -155,32 +167,47 @@ void MPDeviceBleImpl::uploadBundle(QString filePath, QString password, const Mes
         cb(false, "Upload bundle failed");
     });
 
-    connect(jobs, &AsyncJobs::finished, [cb](const QByteArray &)
+    connect(jobs, &AsyncJobs::finished, [this, cb](const QByteArray &)
     {
+        // The new bundle may come with different languages and layouts
+        clearCachedLanguages();
         cb(true, "");
     });
 
     mpDev->enqueueAndRunJob(jobs);
 }
 
-void MPDeviceBleImpl::fetchData(QString filePath, MPCmd::Command cmd)
+void MPDeviceBleImpl::fetchData(QString filePath, MPCmd::Command cmd, FetchDataWriter::Format format, const MPDeviceProgressCb &cbProgress)
 {
+    if (fetchThread)
+    {
+        qWarning() << "A data fetch is already running";
+        return;
+    }
+
     fetchState = Common::FetchState::STARTED;
-    auto *jobs = new AsyncJobs(QString("Fetch Data"), this);
 
-    jobs->append(new MPCommandJob(mpDev, static_cast<quint8>(cmd),
-                    [this, filePath, cmd](const QByteArray &data, bool &) -> bool
-                    {
-                        QFile *file = new QFile(filePath);
-                        if (file->open(QIODevice::WriteOnly))
-                        {
-                            file->write(bleProt->getFullPayload(data));
-                        }
-                        writeFetchData(file, cmd);
-                        return true;
-                    }));
+    fetchThread = new QThread(this);
+    fetchThread->setObjectName("fetch data");
+    fetchWriter = new FetchDataWriter(filePath, format);
+    fetchWriter->moveToThread(fetchThread);
+    connect(fetchThread, &QThread::started, fetchWriter, &FetchDataWriter::start);
+    connect(fetchWriter, &FetchDataWriter::writeError, this, [](const QString &errstr)
+    {
+        qWarning() << errstr;
+    });
+    connect(fetchWriter, &FetchDataWriter::throughputChanged, this, [cbProgress](qint64 totalBytes, qint64 bytesPerSec)
+    {
+        qInfo() << "Fetched" << totalBytes << "bytes," << bytesPerSec << "bytes/s";
+        QVariantMap data = {
+            {"msg", "Fetched %1 bytes (%2 bytes/s)"},
+            {"msg_args", QVariantList({totalBytes, bytesPerSec})}
+        };
+        cbProgress(data);
+    });
+    fetchThread->start();
 
-    mpDev->enqueueAndRunJob(jobs);
+    writeFetchData(cmd);
 }
 
 void MPDeviceBleImpl::checkAndStoreCredential(const BleCredential &cred, MessageHandlerCb cb)
@@ -394,59 +421,60 @@ void MPDeviceBleImpl::flipMessageBit(QByteArray &msg)
 bool MPDeviceBleImpl::processReceivedData(const QByteArray &data, QByteArray &dataReceived)
 {
     const bool isFirst = isFirstPacket(data);
+    const bool isLast = isLastPacket(data);
+    if (isFirst && isLast)
+    {
+        //Single packet message, data is already the full message
+        return true;
+    }
+
     auto& cmd = mpDev->commandQueue.head();
+    cmd.checkReturn = false;
     if (isFirst)
     {
+        /**
+         * The first packet is kept entirely for backward
+         * compatibility with Mini and Classic, the response
+         * is allocated once with its final size and the
+         * payload of the next packets is written in place.
+         */
         cmd.responseSize = bleProt->getMessageSize(data);
-        cmd.response.append(data);
+        cmd.response.resize(cmd.responseSize + MESSAGE_HEADER_SIZE);
+        cmd.responseFill = qMin(data.size(), cmd.response.size());
+        memcpy(cmd.response.data(), data.constData(), static_cast<size_t>(cmd.responseFill));
         /*
          *  When multiple packet from the device expected
          *  start a timer with 2 sec to detect resets and
          *  clean the command queue if it occurs.
          */
-        if (cmd.responseSize > FIRST_PACKET_PAYLOAD_SIZE)
-        {
-            cmd.timerTimeout = new QTimer(this);
-            connect(cmd.timerTimeout, &QTimer::timeout, this, &MPDeviceBleImpl::handleLongMessageTimeout);
-            cmd.timerTimeout->setInterval(LONG_MESSAGE_TIMEOUT_MS);
-            cmd.timerTimeout->start();
-        }
+        m_longMessageTimer.start();
+        return false;
     }
 
-    const bool isLast = isLastPacket(data);
-    if (isLast)
+    const int payloadSize = qMin(data.size() - PACKET_HEADER_SIZE, cmd.response.size() - cmd.responseFill);
+    if (payloadSize > 0)
     {
-        if (!isFirst)
-        {
-            cmd.timerTimeout->stop();
-            /**
-             * @brief EXTRA_INFO_SIZE
-             * Extra bytes of the first packet.
-             * In the last package only the remaining bytes
-             * of payload is appended.
-             */
-            constexpr int EXTRA_INFO_SIZE = 6;
-            int fullResponseSize = cmd.responseSize + EXTRA_INFO_SIZE;
-            QByteArray responseData = cmd.response;
-            if (responseData.size() < fullResponseSize - PAYLOAD_SIZE)
-            {
-                qDebug() << "Not all packet was received";
-                handleLongMessageTimeout();
-                return false;
-            }
-            responseData.append(bleProt->getFullPayload(data).left(fullResponseSize - responseData.size()));
-            dataReceived = responseData;
-        }
+        memcpy(cmd.response.data() + cmd.responseFill, data.constData() + PACKET_HEADER_SIZE, static_cast<size_t>(payloadSize));
+        cmd.responseFill += payloadSize;
     }
-    else
+
+    if (!isLast)
     {
-        if (!isFirst)
-        {
-            cmd.response.append(bleProt->getFullPayload(data));
-        }
-        cmd.checkReturn = false;
+        return false;
+    }
+
+    m_longMessageTimer.stop();
+    if (cmd.response.isEmpty() || cmd.responseFill < cmd.response.size())
+    {
+        qDebug() << "Not all packet was received";
+        handleLongMessageTimeout();
+        return false;
     }
-    return isLast;
+
+    dataReceived = std::move(cmd.response);
+    cmd.response = QByteArray{};
+    cmd.responseFill = 0;
+    return true;
 }
 
  QVector<QByteArray> MPDeviceBleImpl::processReceivedStartNodes(const QByteArray &data) const
@@ -954,6 +982,18 @@ QByteArray MPDeviceBleImpl::getStartAddressToSet(const QVector<QByteArray>& star
 
 void MPDeviceBleImpl::readLanguages(bool onlyCheck)
 {
+    if (INVALID_BUNDLE_VERSION != m_languagesBundleVersion && get_bundleVersion() == m_languagesBundleVersion)
+    {
+        qDebug() << "Languages and layouts are up-to-date for bundle" << m_languagesBundleVersion;
+        emit bleDeviceLanguage(m_deviceLanguages);
+        emit bleKeyboardLayout(m_keyboardLayouts);
+        return;
+    }
+    if (loadCachedLanguages())
+    {
+        return;
+    }
+
     m_deviceLanguages = QJsonObject{};
     m_keyboardLayouts = QJsonObject{};
     AsyncJobs *jobs = new AsyncJobs(
@@ -1050,9 +1090,80 @@ void MPDeviceBleImpl::readLanguages(bool onlyCheck)
                     }
     ));
 
+    connect(jobs, &AsyncJobs::finished, [this](const QByteArray &)
+    {
+        if (!m_deviceLanguages.isEmpty() && !m_keyboardLayouts.isEmpty())
+        {
+            m_languagesBundleVersion = get_bundleVersion();
+            saveCachedLanguages();
+        }
+    });
+
     mpDev->enqueueAndRunJob(jobs);
 }
 
+bool MPDeviceBleImpl::loadCachedLanguages()
+{
+    const auto serialNumber = mpDev->get_serialNumber();
+    if (0 == serialNumber)
+    {
+        return false;
+    }
+
+    QSettings s;
+    const QVariantMap cached = s.value(LANGUAGES_CACHE_SETTING_PREFIX + QString::number(serialNumber)).toMap();
+    if (cached.isEmpty() || cached["bundle_version"].toInt() != get_bundleVersion())
+    {
+        return false;
+    }
+
+    const auto languages = QJsonObject::fromVariantMap(cached["languages"].toMap());
+    const auto layouts = QJsonObject::fromVariantMap(cached["layouts"].toMap());
+    if (languages.isEmpty() || layouts.isEmpty())
+    {
+        return false;
+    }
+
+    qDebug() << "Using cached languages and layouts of bundle" << get_bundleVersion();
+    m_deviceLanguages = languages;
+    m_keyboardLayouts = layouts;
+    m_languagesBundleVersion = get_bundleVersion();
+    s_LangNum = m_deviceLanguages.size();
+    s_LayoutNum = m_keyboardLayouts.size();
+    emit bleDeviceLanguage(m_deviceLanguages);
+    emit bleKeyboardLayout(m_keyboardLayouts);
+    return true;
+}
+
+void MPDeviceBleImpl::saveCachedLanguages()
+{
+    const auto serialNumber = mpDev->get_serialNumber();
+    if (0 == serialNumber)
+    {
+        return;
+    }
+
+    QSettings s;
+    s.setValue(LANGUAGES_CACHE_SETTING_PREFIX + QString::number(serialNumber),
+               QVariantMap{{"bundle_version", m_languagesBundleVersion},
+                           {"languages", m_deviceLanguages.toVariantMap()},
+                           {"layouts", m_keyboardLayouts.toVariantMap()}});
+}
+
+void MPDeviceBleImpl::clearCachedLanguages()
+{
+    m_languagesBundleVersion = INVALID_BUNDLE_VERSION;
+    s_LangNum = 0;
+    s_LayoutNum = 0;
+
+    const auto serialNumber = mpDev->get_serialNumber();
+    if (0 != serialNumber)
+    {
+        QSettings s;
+        s.remove(LANGUAGES_CACHE_SETTING_PREFIX + QString::number(serialNumber));
+    }
+}
+
 void MPDeviceBleImpl::loadWebAuthnNodes(AsyncJobs * jobs, const MPDeviceProgressCb &cbProgress)
 {
     if (mpDev->startNode[Common::WEBAUTHN_ADDR_IDX] != MPNode::EmptyAddress)
@@ -1168,9 +1279,9 @@ void MPDeviceBleImpl::fillMiniExportPayload(QByteArray &unknownCardPayload)
     Common::fill(unknownCardPayload, UNKNOWN_CARD_PAYLOAD_SIZE - payloadSize, ZERO_BYTE);
 }
 
-void MPDeviceBleImpl::convertMiniToBleNode(QByteArray &array)
+bool MPDeviceBleImpl::convertMiniToBleNodes(QVector<QByteArray> &nodes)
 {
-    m_bleNodeConverter.convert(array);
+    return m_bleNodeConverter.convertAll(nodes);
 }
 
 void MPDeviceBleImpl::storeFileData(int current, AsyncJobs *jobs, const MPDeviceProgressCb &cbProgress)
@@ -1287,12 +1398,16 @@ bool MPDeviceBleImpl::isNoBundle(MPCmd::Command cmd)
 void MPDeviceBleImpl::handleLongMessageTimeout()
 {
     qWarning() << "Timout for multiple packet expired";
+    m_longMessageTimer.stop();
+    if (mpDev->commandQueue.isEmpty())
+    {
+        return;
+    }
     auto& cmd = mpDev->commandQueue.head();
-    delete cmd.timerTimeout;
-    cmd.timerTimeout = nullptr;
     cmd.running = false;
     cmd.checkReturn = true;
     cmd.response = QByteArray{};
+    cmd.responseFill = 0;
     mpDev->sendDataDequeue();
 }
 
@@ -1466,24 +1581,54 @@ void MPDeviceBleImpl::sendBundleToDevice(QString filePath, AsyncJobs *jobs, cons
     jobs->append(new MPCommandJob(mpDev, MPCmd::END_BUNDLE_UPLOAD, bleProt->getDefaultFuncDone()));
 }
 
-void MPDeviceBleImpl::writeFetchData(QFile *file, MPCmd::Command cmd)
+void MPDeviceBleImpl::writeFetchData(MPCmd::Command cmd)
 {
     mpDev->sendData(cmd,
-                    [this, file, cmd](bool, const QByteArray &data, bool &) -> bool
+                    [this, cmd](bool success, const QByteArray &data, bool &) -> bool
                     {
-                        file->write(bleProt->getFullPayload(data));
-                        if (Common::FetchState::STARTED == fetchState)
+                        if (!success)
+                        {
+                            qWarning() << "Data fetch failed";
+                            fetchState = Common::FetchState::STOPPED;
+                            stopFetchDataWriter();
+                            return true;
+                        }
+
+                        // Queue the next request before handing the payload to the writer
+                        const bool fetching = Common::FetchState::STARTED == fetchState;
+                        if (fetching)
                         {
-                            writeFetchData(file, cmd);
+                            writeFetchData(cmd);
                         }
-                        else
+
+                        QMetaObject::invokeMethod(fetchWriter, "append", Qt::QueuedConnection,
+                                                  Q_ARG(QByteArray, bleProt->getFullPayload(data)));
+
+                        if (!fetching)
                         {
-                            delete file;
+                            stopFetchDataWriter();
                         }
                         return true;
     });
 }
 
+void MPDeviceBleImpl::stopFetchDataWriter()
+{
+    if (!fetchThread)
+    {
+        return;
+    }
+
+    //Flushes the buffered payloads and closes the file
+    QMetaObject::invokeMethod(fetchWriter, "stop", Qt::BlockingQueuedConnection);
+    fetchThread->quit();
+    fetchThread->wait();
+    delete fetchWriter;
+    delete fetchThread;
+    fetchWriter = nullptr;
+    fetchThread = nullptr;
+}
+
 bool MPDeviceBleImpl::isBundleFileReadable(const QString &filePath)
 {
     return QFile{filePath}.open(QIODevice::ReadOnly);
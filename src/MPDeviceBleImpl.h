@@ -5,8 +5,10 @@
 #include "BleCommon.h"
 #include "MPBLEFreeAddressProvider.h"
 #include "MPMiniToBleNodeConverter.h"
+#include "FetchDataWriter.h"
 
 class MessageProtocolBLE;
+class QThread;
 
 /**
  * @brief The MPDeviceBleImpl class
@@ -47,6 +49,7 @@ class MPDeviceBleImpl: public QObject
 
 public:
     MPDeviceBleImpl(MessageProtocolBLE *mesProt, MPDevice *dev);
+    ~MPDeviceBleImpl();
 
     bool isFirstPacket(const QByteArray &data);
     bool isLastPacket(const QByteArray &data);
@@ -57,7 +60,7 @@ public:
 
     void flashMCU(const MessageHandlerCb &cb);
     void uploadBundle(QString filePath, QString password, const MessageHandlerCb &cb, const MPDeviceProgressCb &cbProgress);
-    void fetchData(QString filePath, MPCmd::Command cmd);
+    void fetchData(QString filePath, MPCmd::Command cmd, FetchDataWriter::Format format, const MPDeviceProgressCb &cbProgress);
     inline void stopFetchData() { fetchState = Common::FetchState::STOPPED; }
 
     void checkAndStoreCredential(const BleCredential &cred, MessageHandlerCb cb);
@@ -121,6 +124,8 @@ public:
     QByteArray getStartAddressToSet(const QVector<QByteArray>& startNodeArray, Common::AddressType addrType) const;
 
     void readLanguages(bool onlyCheck);
+    QJsonObject getDeviceLanguages() const { return m_deviceLanguages; }
+    QJsonObject getKeyboardLayouts() const { return m_keyboardLayouts; }
 
     void loadWebAuthnNodes(AsyncJobs * jobs, const MPDeviceProgressCb &cbProgress);
     void appendLoginNode(MPNode* loginNode, MPNode* loginNodeClone, Common::AddressType addrType);
@@ -133,7 +138,7 @@ public:
     void addUserIdPlaceholder(QByteArray &array);
     void fillMiniExportPayload(QByteArray &unknownCardPayload);
 
-    void convertMiniToBleNode(QByteArray &array);
+    bool convertMiniToBleNodes(QVector<QByteArray> &nodes);
 
     void storeFileData(int current, AsyncJobs * jobs, const MPDeviceProgressCb &cbProgress);
 
@@ -157,9 +162,14 @@ public slots:
 private:
     void checkDataFlash(const QByteArray &data, QElapsedTimer *timer, AsyncJobs *jobs, QString filePath, const MPDeviceProgressCb &cbProgress);
     void sendBundleToDevice(QString filePath, AsyncJobs *jobs, const MPDeviceProgressCb &cbProgress);
-    void writeFetchData(QFile *file, MPCmd::Command cmd);
+    void writeFetchData(MPCmd::Command cmd);
+    void stopFetchDataWriter();
     inline bool isBundleFileReadable(const QString& filePath);
 
+    bool loadCachedLanguages();
+    void saveCachedLanguages();
+    void clearCachedLanguages();
+
     QByteArray createStoreCredMessage(const BleCredential &cred);
     QByteArray createGetCredMessage(QString service, QString login);
     QByteArray createCheckCredMessage(const BleCredential &cred);
@@ -173,17 +183,24 @@ private:
     MessageProtocolBLE *bleProt;
     MPDevice *mpDev;
     Common::FetchState fetchState = Common::FetchState::STOPPED;
+    // Fetched payloads are written from this thread
+    QThread *fetchThread = nullptr;
+    FetchDataWriter *fetchWriter = nullptr;
 
     quint8 m_flipBit = 0x00;
     quint8 m_currentUserSettings = 0x00;
     QString m_debugMsg = "";
 
     MPBLEFreeAddressProvider freeAddressProv;
+    // Detects device resets while a multiple packet message is received
+    QTimer m_longMessageTimer;
     QJsonObject m_categories;
     QJsonObject m_categoriesToImport;
     bool m_categoriesFetched = false;
     QJsonObject m_deviceLanguages;
     QJsonObject m_keyboardLayouts;
+    // Bundle version the language and layout tables were read from
+    int m_languagesBundleVersion = INVALID_BUNDLE_VERSION;
     MPMiniToBleNodeConverter m_bleNodeConverter;
     QList<QByteArray> mmmTOTPStoreArray;
 
@@ -207,8 +224,13 @@ private:
     static constexpr int LONG_MESSAGE_TIMEOUT_MS = 2000;
     static constexpr int FIRST_PACKET_PAYLOAD_SIZE = 58;
     static constexpr int PAYLOAD_SIZE = 62;
+    static constexpr int PACKET_HEADER_SIZE = 2;
+    // Packet header, command and payload length of the first packet
+    static constexpr int MESSAGE_HEADER_SIZE = 6;
     static constexpr int INVALID_LAYOUT_LANG_SIZE = 0xFFFF;
     const QString AFTER_AUX_FLASH_SETTING = "settings/after_aux_flash";
+    const QString LANGUAGES_CACHE_SETTING_PREFIX = "settings/device_languages_";
+    static constexpr int INVALID_BUNDLE_VERSION = -1;
     static constexpr int UNKNOWN_CARD_PAYLOAD_SIZE = 72;
     const static char ZERO_BYTE = static_cast<char>(0x00);
     const static int BLE_DATA_BLOCK_SIZE = 512;
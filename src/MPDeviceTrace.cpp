@@ -0,0 +1,231 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Moolticute; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "MPDeviceTrace.h"
+#include <QDebug>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QTextStream>
+
+static const char *TRACE_HEADER = "# moolticute-trace";
+static const char *LOCAL_DEVICE_SOCKET = "moolticuted_local_dev";
+
+bool MPTrace::load(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        qWarning() << "Failed to open trace file: " << path;
+        return false;
+    }
+
+    packets.clear();
+    QTextStream in(&file);
+    while (!in.atEnd())
+    {
+        const QString line = in.readLine().trimmed();
+        if (line.isEmpty())
+            continue;
+
+        if (line.startsWith(TRACE_HEADER))
+        {
+            isBLE = line.contains("ble=1");
+            isBluetooth = line.contains("bt=1");
+            continue;
+        }
+        if (line.startsWith('#'))
+            continue;
+
+        const QStringList fields = line.split(' ', QString::SkipEmptyParts);
+        if (fields.size() != 3 || (fields[1] != "W" && fields[1] != "R"))
+        {
+            qWarning() << "Invalid trace line: " << line;
+            return false;
+        }
+
+        MPTracePacket packet;
+        packet.ts = fields[0].toLongLong();
+        packet.dir = fields[1] == "W" ? MPTracePacket::Write : MPTracePacket::Read;
+        packet.data = QByteArray::fromHex(fields[2].toLatin1());
+        packets.append(packet);
+    }
+
+    return true;
+}
+
+MPTraceRecorder::MPTraceRecorder(const QString &path, bool isBLE, bool isBluetooth):
+    file(sessionPath(path))
+{
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
+    {
+        qWarning() << "Failed to open trace file for recording: " << file.fileName();
+        return;
+    }
+
+    QTextStream out(&file);
+    out << TRACE_HEADER << ' ' << MPTrace::TRACE_VERSION
+        << " ble=" << (isBLE ? 1 : 0) << " bt=" << (isBluetooth ? 1 : 0) << '\n';
+    out.flush();
+    elapsed.start();
+    qInfo() << "Recording device trace to: " << file.fileName();
+}
+
+QString MPTraceRecorder::sessionPath(const QString &path)
+{
+    //One file per device connection: trace.log -> trace-20200131-235959.log
+    const QFileInfo info(path);
+    const QString suffix = info.completeSuffix().isEmpty() ? QString() : '.' + info.completeSuffix();
+    const QString base = info.dir().filePath(info.baseName() + '-' +
+                                             QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"));
+
+    QString filePath = base + suffix;
+    for (int i = 2; QFileInfo::exists(filePath); ++i)
+    {
+        filePath = QString("%1-%2%3").arg(base).arg(i).arg(suffix);
+    }
+    return filePath;
+}
+
+void MPTraceRecorder::record(MPTracePacket::Direction dir, const QByteArray &data)
+{
+    if (!file.isOpen())
+        return;
+
+    QTextStream out(&file);
+    out << elapsed.elapsed() << (dir == MPTracePacket::Write ? " W " : " R ")
+        << data.toHex() << '\n';
+    out.flush();
+}
+
+MPTraceReplayServer::MPTraceReplayServer(const MPTrace &trace, double latencyScale, QObject *parent):
+    QObject(parent),
+    m_trace(trace),
+    m_latencyScale(latencyScale)
+{
+    m_sendTimer.setSingleShot(true);
+    connect(&m_sendTimer, &QTimer::timeout, this, &MPTraceReplayServer::sendPendingReads);
+}
+
+bool MPTraceReplayServer::start()
+{
+    if (!m_trace.isBLE)
+    {
+        qWarning() << "Only BLE traces can be replayed over the local device socket";
+        return false;
+    }
+
+    m_socket = new QLocalSocket(this);
+    connect(m_socket, &QLocalSocket::readyRead, this, &MPTraceReplayServer::readData);
+    m_socket->connectToServer(LOCAL_DEVICE_SOCKET);
+    if (!m_socket->waitForConnected())
+    {
+        qWarning() << "Failed to connect to local device socket: " << m_socket->errorString();
+        return false;
+    }
+
+    // A trace may start with packets pushed by the device
+    scheduleReads();
+    return true;
+}
+
+void MPTraceReplayServer::readData()
+{
+    if (!m_socket)
+        return;
+
+    m_incoming.append(m_socket->readAll());
+
+    while (m_incoming.size() >= HID_PACKET_HEADER_SIZE)
+    {
+        const int packetSize = HID_PACKET_HEADER_SIZE + (static_cast<quint8>(m_incoming[0]) & HID_PACKET_LEN_MASK);
+        if (m_incoming.size() < packetSize)
+            break;
+
+        const QByteArray packet = m_incoming.left(packetSize);
+        m_incoming.remove(0, packetSize);
+        ++m_packetsWritten;
+
+        if (m_cursor < m_trace.packets.size() && m_trace.packets[m_cursor].dir == MPTracePacket::Write)
+        {
+            if (trimPacket(m_trace.packets[m_cursor].data) != packet)
+            {
+                ++m_mismatches;
+                qDebug() << "Trace mismatch at packet" << m_cursor << ": expected"
+                         << m_trace.packets[m_cursor].data.toHex() << "got" << packet.toHex();
+            }
+            ++m_cursor;
+        }
+        else
+        {
+            ++m_mismatches;
+            qDebug() << "Unexpected packet written by the daemon: " << packet.toHex();
+        }
+    }
+
+    scheduleReads();
+}
+
+void MPTraceReplayServer::scheduleReads()
+{
+    if (m_sendTimer.isActive())
+        return;
+
+    if (isFinished())
+    {
+        if (!m_finishedEmitted)
+        {
+            m_finishedEmitted = true;
+            emit finished();
+        }
+        return;
+    }
+
+    if (m_trace.packets[m_cursor].dir != MPTracePacket::Read)
+        return;
+
+    qint64 delay = 0;
+    if (m_cursor > 0)
+        delay = m_trace.packets[m_cursor].ts - m_trace.packets[m_cursor - 1].ts;
+
+    m_sendTimer.start(static_cast<int>(qMax<qint64>(0, delay) * m_latencyScale));
+}
+
+void MPTraceReplayServer::sendPendingReads()
+{
+    if (!m_socket || isFinished() || m_trace.packets[m_cursor].dir != MPTracePacket::Read)
+        return;
+
+    m_socket->write(trimPacket(m_trace.packets[m_cursor].data));
+    m_socket->flush();
+    ++m_packetsRead;
+    ++m_cursor;
+
+    scheduleReads();
+}
+
+QByteArray MPTraceReplayServer::trimPacket(const QByteArray &packet)
+{
+    // hidraw packets are always 64 bytes, the local socket stream is
+    // framed using the payload length of each packet
+    if (packet.size() < HID_PACKET_HEADER_SIZE)
+        return packet;
+
+    const int packetSize = HID_PACKET_HEADER_SIZE + (static_cast<quint8>(packet[0]) & HID_PACKET_LEN_MASK);
+    return packet.left(qMin(packetSize, HID_PACKET_SIZE));
+}
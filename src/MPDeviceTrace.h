@@ -0,0 +1,138 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Moolticute; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef MPDEVICETRACE_H
+#define MPDEVICETRACE_H
+
+#include <QObject>
+#include <QFile>
+#include <QElapsedTimer>
+#include <QLocalSocket>
+#include <QPointer>
+#include <QTimer>
+
+/**
+ * A trace is a plain text file containing every HID packet exchanged
+ * between the daemon and a device:
+ *
+ *   # moolticute-trace 1 ble=1 bt=0
+ *   <ms since start> W <hex>   packet written to the device
+ *   <ms since start> R <hex>   packet read from the device
+ */
+struct MPTracePacket
+{
+    enum Direction
+    {
+        Write,
+        Read
+    };
+
+    qint64 ts = 0;
+    Direction dir = Write;
+    QByteArray data;
+};
+
+class MPTrace
+{
+public:
+    bool load(const QString &path);
+
+    QList<MPTracePacket> packets;
+    bool isBLE = true;
+    bool isBluetooth = false;
+
+    static constexpr int TRACE_VERSION = 1;
+};
+
+/**
+ * @brief The MPTraceRecorder class
+ * Append every packet going through a platform device to a trace file.
+ * Each device connection gets its own file, the given path with the
+ * connection time appended, so a reconnect does not erase a trace.
+ * Packets are flushed right away so a trace survives a daemon crash.
+ */
+class MPTraceRecorder
+{
+public:
+    MPTraceRecorder(const QString &path, bool isBLE, bool isBluetooth);
+
+    bool isOpen() const { return file.isOpen(); }
+
+    void recordWrite(const QByteArray &data) { record(MPTracePacket::Write, data); }
+    void recordRead(const QByteArray &data) { record(MPTracePacket::Read, data); }
+
+private:
+    static QString sessionPath(const QString &path);
+    void record(MPTracePacket::Direction dir, const QByteArray &data);
+
+    QFile file;
+    QElapsedTimer elapsed;
+};
+
+/**
+ * @brief The MPTraceReplayServer class
+ * Plays the device side of a recorded trace. It connects to the daemon
+ * local device socket (the same one used by the emulator) and answers
+ * each packet written by the daemon with the packets read during the
+ * recorded session, waiting the original delay multiplied by latencyScale.
+ * Only BLE traces can be replayed, local socket devices are always BLE.
+ */
+class MPTraceReplayServer: public QObject
+{
+    Q_OBJECT
+public:
+    MPTraceReplayServer(const MPTrace &trace, double latencyScale = 1.0, QObject *parent = nullptr);
+
+    bool start();
+
+    int packetsWritten() const { return m_packetsWritten; }
+    int packetsRead() const { return m_packetsRead; }
+    int mismatches() const { return m_mismatches; }
+    bool isFinished() const { return m_cursor >= m_trace.packets.size(); }
+
+signals:
+    void finished();
+
+private slots:
+    void readData();
+    void sendPendingReads();
+
+private:
+    void scheduleReads();
+    static QByteArray trimPacket(const QByteArray &packet);
+
+    MPTrace m_trace;
+    double m_latencyScale;
+    QPointer<QLocalSocket> m_socket;
+    QTimer m_sendTimer;
+
+    int m_cursor = 0;
+    int m_packetsWritten = 0;
+    int m_packetsRead = 0;
+    int m_mismatches = 0;
+    bool m_finishedEmitted = false;
+
+    // incoming messages, same framing as MPDevice_localSocket
+    QByteArray m_incoming;
+
+    static constexpr int HID_PACKET_SIZE = 64;
+    static constexpr int HID_PACKET_HEADER_SIZE = 2;
+    static constexpr quint8 HID_PACKET_LEN_MASK = 63;
+};
+
+#endif // MPDEVICETRACE_H
@@ -19,6 +19,7 @@
 #include "MPDevice_linux.h"
 #include "UsbMonitor_linux.h"
 #include "BleCommon.h"
+#include "AppDaemon.h"
 
 #include <linux/hidraw.h>
 #include <linux/version.h>
@@ -31,6 +32,7 @@
 #include <unistd.h>
 
 int MPDevice_linux::INVALID_VALUE = -1;
+QHash<QString, MPDevice_linux::CachedProbe> MPDevice_linux::probeCache;
 
 MPDevice_linux::MPDevice_linux(QObject *parent, const MPPlatformDef &platformDef):
     MPDevice(parent),
@@ -53,11 +55,17 @@ MPDevice_linux::MPDevice_linux(QObject *parent, const MPPlatformDef &platformDef
         sockNotifRead = new QSocketNotifier(devfd, QSocketNotifier::Read);
         connect(sockNotifRead, &QSocketNotifier::activated, this, &MPDevice_linux::readyRead);
     }
+
+    if (!AppDaemon::getTraceFilePath().isEmpty())
+    {
+        traceRecorder = new MPTraceRecorder(AppDaemon::getTraceFilePath(), platformDef.isBLE, platformDef.isBluetooth);
+    }
 }
 
 MPDevice_linux::~MPDevice_linux()
 {
     delete sockNotifRead;
+    delete traceRecorder;
 
     if (devfd > 0)
     {
@@ -88,13 +96,16 @@ void MPDevice_linux::readyRead(int fd)
     {
         if (isBluetooth)
         {
-            emit platformDataRead(recvData.remove(0,1));
+            recvData.remove(0,1);
         }
-        else
+
+        if (traceRecorder)
         {
-            emit platformDataRead(recvData);
+            traceRecorder->recordRead(recvData);
         }
 
+        emit platformDataRead(recvData);
+
         failToWriteLogged = false;
     }
 
@@ -104,6 +115,11 @@ void MPDevice_linux::readyRead(int fd)
 //Start a send request, buffer the data if needed
 void MPDevice_linux::platformWrite(const QByteArray &ba)
 {
+    if (traceRecorder)
+    {
+        traceRecorder->recordWrite(ba);
+    }
+
     sendBuffer.enqueue(ba);
     writeNextPacket();
 }
@@ -124,8 +140,17 @@ int MPDevice_linux::getDescriptorSize(const char *devpath)
     return descSize;
 }
 
-bool MPDevice_linux::checkDevice(struct udev_device *raw_dev, bool &isBLE, bool &isBT)
+MPDevice_linux::ProbeResult MPDevice_linux::probeDevice(struct udev_device *raw_dev, bool &isBLE, bool &isBT)
 {
+    const QString sysPath = QString::fromUtf8(udev_device_get_syspath(raw_dev));
+    auto cached = probeCache.find(sysPath);
+    if (cached != probeCache.end())
+    {
+        isBLE = cached->isBLE;
+        isBT = cached->isBT;
+        return cached->isMooltipass ? ProbeResult::MOOLTIPASS : ProbeResult::NOT_MOOLTIPASS;
+    }
+
     int bus_type = 0;
     unsigned short dev_vid = 0;
     unsigned short dev_pid = 0;
@@ -134,10 +159,10 @@ bool MPDevice_linux::checkDevice(struct udev_device *raw_dev, bool &isBLE, bool
 
     struct udev_device *hid_dev = udev_device_get_parent_with_subsystem_devtype(raw_dev, "hid", nullptr);
 
-    if (!hid_dev)
+    if (!hid_dev || !dev_path)
     {
-        udev_device_unref(raw_dev);
-        return false;
+        probeCache.insert(sysPath, CachedProbe{});
+        return ProbeResult::NOT_MOOLTIPASS;
     }
 
     QString uevent = QString::fromUtf8(udev_device_get_sysattr_value(hid_dev, "uevent"));
@@ -159,21 +184,48 @@ bool MPDevice_linux::checkDevice(struct udev_device *raw_dev, bool &isBLE, bool
 
     bool isMini = dev_vid == MOOLTIPASS_VENDORID && dev_pid == MOOLTIPASS_PRODUCTID;
     bool isBle = dev_vid == MOOLTIPASS_BLE_VENDORID && dev_pid == MOOLTIPASS_BLE_PRODUCTID;
-    if ((bus_type == BUS_USB || bus_type == BUS_BLUETOOTH) &&
-        (isMini || isBle))
+    if (!(bus_type == BUS_USB || bus_type == BUS_BLUETOOTH) ||
+        !(isMini || isBle))
     {
-        const auto descSize = getDescriptorSize(dev_path);
-        if (MOOLTIPASS_USBHID_DESC_SIZE == descSize ||
-            MOOLTIPASS_BLEHID_DESC_SIZE == descSize)
-        {
-            isBLE = isBle;
-            isBT = bus_type == BUS_BLUETOOTH;
-            return true;
-        }
+        probeCache.insert(sysPath, CachedProbe{});
+        return ProbeResult::NOT_MOOLTIPASS;
+    }
+
+    //udev rules may not have been applied yet right after the node is created
+    if (access(dev_path, R_OK | W_OK) != 0)
+    {
+        return ProbeResult::NOT_READY;
     }
 
-    udev_device_unref(raw_dev);
-    return false;
+    const auto descSize = getDescriptorSize(dev_path);
+    if (0 == descSize)
+    {
+        return ProbeResult::NOT_READY;
+    }
+
+    CachedProbe probe;
+    if (MOOLTIPASS_USBHID_DESC_SIZE == descSize ||
+        MOOLTIPASS_BLEHID_DESC_SIZE == descSize)
+    {
+        probe.isMooltipass = true;
+        probe.isBLE = isBle;
+        probe.isBT = bus_type == BUS_BLUETOOTH;
+    }
+    probeCache.insert(sysPath, probe);
+
+    isBLE = probe.isBLE;
+    isBT = probe.isBT;
+    return probe.isMooltipass ? ProbeResult::MOOLTIPASS : ProbeResult::NOT_MOOLTIPASS;
+}
+
+bool MPDevice_linux::checkDevice(struct udev_device *raw_dev, bool &isBLE, bool &isBT)
+{
+    return probeDevice(raw_dev, isBLE, isBT) == ProbeResult::MOOLTIPASS;
+}
+
+void MPDevice_linux::forgetDevice(const QString &sysPath)
+{
+    probeCache.remove(sysPath);
 }
 
 void MPDevice_linux::writeNextPacket()
@@ -228,6 +280,9 @@ QList<MPPlatformDef> MPDevice_linux::enumerateDevices()
     {
         const char *sysfs_path = udev_list_entry_get_name(dev);
         struct udev_device *raw_dev = udev_device_new_from_syspath(udev, sysfs_path);
+        if (!raw_dev)
+            continue;
+
         bool isBLE, isBT;
         if (checkDevice(raw_dev, isBLE, isBT))
         {
@@ -241,6 +296,7 @@ QList<MPPlatformDef> MPDevice_linux::enumerateDevices()
 
             qDebug() << "Found mooltipass: " << def.path;
         }
+        udev_device_unref(raw_dev);
     }
 
     udev_enumerate_unref(enumerate);
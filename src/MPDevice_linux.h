@@ -20,6 +20,7 @@
 #define MPDEVICE_LINUX_H
 
 #include "MPDevice.h"
+#include "MPDeviceTrace.h"
 #include <QSocketNotifier>
 
 #include <QThread>
@@ -46,17 +47,46 @@ public:
     //Static function for enumerating devices on platform
     static QList<MPPlatformDef> enumerateDevices();
     static int getDescriptorSize(const char* devpath);
+
+    enum class ProbeResult
+    {
+        NOT_MOOLTIPASS,
+        MOOLTIPASS,
+        NOT_READY       // mooltipass ids, but the node cannot be opened yet
+    };
+
     /**
-     * @brief checkDevice
-     * Checking if the device is a mooltipass device
-     * @param path to the device
+     * @brief probeDevice
+     * Checking if the device is a mooltipass device.
+     * Results are cached by sysfs path, so a node is only
+     * opened once for its descriptor size.
+     * @param raw_dev udev device, not unrefed
      * @param isBLE out param, true if device is a ble
      * @param isBT out param, true if device is connected with BT
-     * @return true, if the device is mini/ble
+     */
+    static ProbeResult probeDevice(struct udev_device *raw_dev, bool &isBLE, bool &isBT);
+    /**
+     * @brief checkDevice
+     * @return true, if the device is mini/ble and ready to be opened
      */
     static bool checkDevice(struct udev_device *raw_dev, bool &isBLE, bool &isBT);
+    /**
+     * @brief forgetDevice
+     * Drop the cached probe result when the node is removed
+     * @param sysPath sysfs path of the hidraw node
+     */
+    static void forgetDevice(const QString &sysPath);
     static int INVALID_VALUE;
 
+private:
+    struct CachedProbe
+    {
+        bool isMooltipass = false;
+        bool isBLE = false;
+        bool isBT = false;
+    };
+    static QHash<QString, CachedProbe> probeCache;
+
 private slots:
     void readyRead(int fd);
     void writeNextPacket();
@@ -69,6 +99,9 @@ private:
     int devfd = 0; //device fd
     QSocketNotifier *sockNotifRead = nullptr;
 
+    //Set when the daemon is started with --record-trace
+    MPTraceRecorder *traceRecorder = nullptr;
+
     //Bufferize the data sent by sending 64bytes packet at a time
     QQueue<QByteArray> sendBuffer;
     bool failToWriteLogged = false;
@@ -1,5 +1,6 @@
 #include "MessageProtocolBLE.h"
 #include "MPNodeBLE.h"
+#include <cstring>
 
 MessageProtocolBLE::MessageProtocolBLE()
 {
@@ -142,7 +143,12 @@ QString MessageProtocolBLE::getDeviceName() const
 QByteArray MessageProtocolBLE::toByteArray(const QString &input)
 {
     //Convert string to unicode byte array (2 bytes for 1 char)
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    //QString already stores little endian UTF-16, copy it at once
+    return QByteArray(reinterpret_cast<const char *>(input.utf16()), input.size() * 2);
+#else
     QByteArray unicodeArray;
+    unicodeArray.reserve(input.size() * 2);
     for (QChar ch : input)
     {
         quint16 uniChar = ch.unicode();
@@ -150,27 +156,36 @@ QByteArray MessageProtocolBLE::toByteArray(const QString &input)
         unicodeArray.append(static_cast<char>((0xFF00&uniChar)>>8));
     }
     return unicodeArray;
+#endif
 }
 
 QString MessageProtocolBLE::toQString(const QByteArray &data)
 {
-    QString out = "";
-    const auto size = data.size();
-    for (int i = 0; i < size; i+=2)
+    const char *raw = data.constData();
+    const int size = data.size();
+
+    //Find the null terminator first, then convert the whole string at once
+    int len = 0;
+    while (len + 1 < size && (raw[len] | raw[len + 1]) != 0)
+    {
+        len += 2;
+    }
+    if (len + 1 == size)
+    {
+        qCritical() << "Out of bounds";
+    }
+    len /= 2;
+
+    QString out(len, Qt::Uninitialized);
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    memcpy(out.data(), raw, static_cast<size_t>(len) * 2);
+#else
+    QChar *dst = out.data();
+    for (int i = 0; i < len; ++i)
     {
-        if (i+1 >= size)
-        {
-            qCritical() << "Out of bounds";
-            break;
-        }
-        quint16 unicode = static_cast<quint8>(data[i]);
-        unicode |= (data[i+1]<<8);
-        if (0 == unicode)
-        {
-            return out;
-        }
-        out += QChar(unicode);
+        dst[i] = QChar(static_cast<quint16>(static_cast<quint8>(raw[2*i]) | (static_cast<quint8>(raw[2*i + 1]) << 8)));
     }
+#endif
     return out;
 }
 
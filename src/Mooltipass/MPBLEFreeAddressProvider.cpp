@@ -8,15 +8,25 @@ MPBLEFreeAddressProvider::MPBLEFreeAddressProvider(MessageProtocolBLE *mesProt,
 
 }
 
+void MPBLEFreeAddressProvider::incrementParentNodeNeeded(int virtualAddr)
+{
+    ++m_parentNodeNeeded;
+    m_parentVirtualAddrs.append(virtualAddr);
+    reserveVirtualAddress(virtualAddr);
+}
+
+void MPBLEFreeAddressProvider::incrementChildNodeNeeded(int virtualAddr)
+{
+    ++m_childNodeNeeded;
+    m_childVirtualAddrs.append(virtualAddr);
+    reserveVirtualAddress(virtualAddr);
+}
+
 QByteArray MPBLEFreeAddressProvider::getFreeAddress(const int virtualAddr)
 {
-    if (m_parentAddrMapping.contains(virtualAddr))
-    {
-        return m_parentAddrMapping[virtualAddr];
-    }
-    else if (m_childAddrMapping.contains(virtualAddr))
+    if (virtualAddr > 0 && virtualAddr < m_freeAddresses.size() && !m_freeAddresses[virtualAddr].isEmpty())
     {
-        return m_childAddrMapping[virtualAddr];
+        return m_freeAddresses[virtualAddr];
     }
     qCritical() << "No address loaded for virtual address: " << virtualAddr;
     return QByteArray{};
@@ -35,6 +45,8 @@ void MPBLEFreeAddressProvider::loadFreeAddresses(AsyncJobs *jobs, const QByteArr
     FreeAddressInfo addressInfo;
     addressInfo.parentNodeRequested = getNodeAskedNumber(MPNode::NodeParent, freeAddrNum);
     addressInfo.childNodeRequested = getNodeAskedNumber(MPNode::NodeChild, freeAddrNum);
+    addressInfo.newParentAddresses = addressInfo.parentNodeRequested;
+    addressInfo.newChildAddresses = addressInfo.childNodeRequested;
     addressPackage.append(bleProt->toLittleEndianFromInt(addressInfo.parentNodeRequested));
     addressPackage.append(bleProt->toLittleEndianFromInt(addressInfo.childNodeRequested));
 
@@ -45,9 +57,20 @@ void MPBLEFreeAddressProvider::loadFreeAddresses(AsyncJobs *jobs, const QByteArr
 void MPBLEFreeAddressProvider::cleanFreeAddresses()
 {
     m_parentNodeNeeded = 0;
-    m_parentAddrMapping.clear();
     m_childNodeNeeded = 0;
-    m_childAddrMapping.clear();
+    m_freeAddresses.clear();
+    m_parentVirtualAddrs.clear();
+    m_childVirtualAddrs.clear();
+    m_parentAddrReceived = 0;
+    m_childAddrReceived = 0;
+}
+
+void MPBLEFreeAddressProvider::reserveVirtualAddress(int virtualAddr)
+{
+    if (virtualAddr >= m_freeAddresses.size())
+    {
+        m_freeAddresses.resize(virtualAddr + 1);
+    }
 }
 
 quint16 MPBLEFreeAddressProvider::getNodeAskedNumber(MPNode::NodeType nodeType, int &freeAddrNum)
@@ -73,16 +96,14 @@ quint16 MPBLEFreeAddressProvider::getNodeAskedNumber(MPNode::NodeType nodeType,
     return 0;
 }
 
-void MPBLEFreeAddressProvider::processReceivedAddrNumber(MPNode::NodeType nodeType, const QByteArray &receivedAddr, int &pos)
+void MPBLEFreeAddressProvider::processReceivedAddrNumber(MPNode::NodeType nodeType, const QByteArray &receivedAddr, int &pos, int count)
 {
-    auto& m_addrMapping = MPNode::NodeParent == nodeType ? m_parentAddrMapping : m_childAddrMapping;
-    for (auto& ba : m_addrMapping)
+    const auto& virtualAddrs = MPNode::NodeParent == nodeType ? m_parentVirtualAddrs : m_childVirtualAddrs;
+    auto& received = MPNode::NodeParent == nodeType ? m_parentAddrReceived : m_childAddrReceived;
+    for (int i = 0; i < count && received < virtualAddrs.size(); ++i)
     {
-        if (ba.isEmpty())
-        {
-            ba.append(receivedAddr.mid(pos, MPNode::ADDRESS_LENGTH));
-            pos += MPNode::ADDRESS_LENGTH;
-        }
+        m_freeAddresses[virtualAddrs[received++]] = receivedAddr.mid(pos, MPNode::ADDRESS_LENGTH);
+        pos += MPNode::ADDRESS_LENGTH;
     }
 }
 
@@ -98,6 +119,8 @@ void MPBLEFreeAddressProvider::loadRemainingFreeAddresses(AsyncJobs *jobs, const
     FreeAddressInfo addressInfo;
     addressInfo.parentNodeRequested = getNodeAskedNumber(MPNode::NodeParent, freeAddrNum);
     addressInfo.childNodeRequested = getNodeAskedNumber(MPNode::NodeChild, freeAddrNum);
+    addressInfo.newParentAddresses = addressInfo.parentNodeRequested;
+    addressInfo.newChildAddresses = addressInfo.childNodeRequested;
     /*
      * Increasing the requested node number of addressFrom's type,
      * because it will be received again in the response.
@@ -140,8 +163,17 @@ MPCommandJob* MPBLEFreeAddressProvider::createGetFreeAddressPackage(AsyncJobs *j
 
                 int pos = addressInfo.startingPosition;
 
-                processReceivedAddrNumber(MPNode::NodeParent, receivedAddresses, pos);
-                processReceivedAddrNumber(MPNode::NodeChild, receivedAddresses, pos);
+                processReceivedAddrNumber(MPNode::NodeParent, receivedAddresses, pos, addressInfo.newParentAddresses);
+                processReceivedAddrNumber(MPNode::NodeChild, receivedAddresses, pos, addressInfo.newChildAddresses);
+
+                const int totalNeeded = m_parentVirtualAddrs.size() + m_childVirtualAddrs.size();
+                const int totalReceived = m_parentAddrReceived + m_childAddrReceived;
+                QVariantMap progressData = { {"total", totalNeeded},
+                                             {"current", totalReceived},
+                                             {"msg", "%1 Free Addresses Received"},
+                                             {"msg_args", QVariantList({totalReceived})}
+                                           };
+                cbProgress(progressData);
 
                 // There are more needed nodes
                 if (m_parentNodeNeeded + m_childNodeNeeded > 0)
@@ -11,14 +11,17 @@ class MPBLEFreeAddressProvider
     {
         int parentNodeRequested = 0;
         int childNodeRequested = 0;
+        // Requested addresses which are not the repeated addressFrom
+        int newParentAddresses = 0;
+        int newChildAddresses = 0;
         int startingPosition = 0;
     };
 
 public:
     MPBLEFreeAddressProvider(MessageProtocolBLE *mesProt, MPDevice *dev);
 
-    void incrementParentNodeNeeded(int mappingAddr) { ++m_parentNodeNeeded; m_parentAddrMapping[mappingAddr] = QByteArray{}; }
-    void incrementChildNodeNeeded(int mappingAddr) { ++m_childNodeNeeded; m_childAddrMapping[mappingAddr] = QByteArray{}; }
+    void incrementParentNodeNeeded(int virtualAddr);
+    void incrementChildNodeNeeded(int virtualAddr);
     QByteArray getFreeAddress(const int virtualAddr);
     void loadFreeAddresses(AsyncJobs *jobs, const QByteArray &addressFrom, const MPDeviceProgressCb &cbProgress);
     void cleanFreeAddresses();
@@ -31,7 +34,8 @@ private:
      * @return Number of addresses which will requested in the next packet of nodeType
      */
     quint16 getNodeAskedNumber(MPNode::NodeType nodeType, int& freeAddrNum);
-    void processReceivedAddrNumber(MPNode::NodeType nodeType, const QByteArray& receivedAddr, int& pos);
+    void reserveVirtualAddress(int virtualAddr);
+    void processReceivedAddrNumber(MPNode::NodeType nodeType, const QByteArray& receivedAddr, int& pos, int count);
     void loadRemainingFreeAddresses(AsyncJobs *jobs, const QByteArray &addressFrom, const MPDeviceProgressCb &cbProgress, bool isLastChild);
     MPCommandJob* createGetFreeAddressPackage(AsyncJobs *jobs, const MPDeviceProgressCb &cbProgress, FreeAddressInfo addressInfo, const QByteArray& addrPackage);
 
@@ -41,8 +45,17 @@ private:
 
     int m_parentNodeNeeded = 0;
     int m_childNodeNeeded = 0;
-    QMap<int, QByteArray> m_parentAddrMapping;
-    QMap<int, QByteArray> m_childAddrMapping;
+    /*
+     * Virtual addresses are handed out sequentially, so the received
+     * addresses are stored in a flat array indexed by virtual address.
+     * Parent and child virtual addresses are kept in the order they were
+     * requested, the device answers with the addresses in the same order.
+     */
+    QVector<QByteArray> m_freeAddresses;
+    QVector<int> m_parentVirtualAddrs;
+    QVector<int> m_childVirtualAddrs;
+    int m_parentAddrReceived = 0;
+    int m_childAddrReceived = 0;
 
     static constexpr int MAX_FREE_ADDR_REQ = 266;
 };
@@ -1,12 +1,13 @@
 #include "MPMiniToBleNodeConverter.h"
 #include "Common.h"
+#include <QtConcurrent/QtConcurrent>
 
 MPMiniToBleNodeConverter::MPMiniToBleNodeConverter()
 {
 
 }
 
-void MPMiniToBleNodeConverter::convert(QByteArray &dataArray)
+void MPMiniToBleNodeConverter::convert(QByteArray &dataArray) const
 {
     const bool childNode = dataArray[1]&CHILD_NODE_FLAG;
 
@@ -20,70 +21,91 @@ void MPMiniToBleNodeConverter::convert(QByteArray &dataArray)
     }
 }
 
-QByteArray MPMiniToBleNodeConverter::convertMiniParentNodeToBle(const QByteArray &dataArray)
+bool MPMiniToBleNodeConverter::convertAll(QVector<QByteArray> &nodes) const
 {
+    for (const auto& node : nodes)
+    {
+        if (node.size() != MP_NODE_SIZE)
+        {
+            qCritical() << "Invalid Mini node size for conversion: " << node.size();
+            return false;
+        }
+    }
+
+    QtConcurrent::blockingMap(nodes, [this](QByteArray &node)
+    {
+        convert(node);
+    });
+
+    return true;
+}
+
+QByteArray MPMiniToBleNodeConverter::convertMiniParentNodeToBle(const QByteArray &dataArray) const
+{
+    // The converted node is written in place, unused fields stay zero
+    QByteArray bleArray(BLE_PARENT_NODE_SIZE, ZERO_BYTE);
+    char *out = bleArray.data();
+    const char *in = dataArray.constData();
     // Flags, prev, next parent, first child
-    QByteArray bleArray = dataArray.left(PARENT_ADDRESSES);
-    // Converting service name to ascii
+    memcpy(out, in, PARENT_ADDRESSES);
+    // Converting service name to ascii, remaining service name and reserved byte are zero
+    int pos = PARENT_ADDRESSES;
     for (int i = PARENT_ADDRESSES; i <= MINI_SERVICE_LAST_BYTE; ++i)
     {
-        bleArray.append(dataArray[i]);
-        bleArray.append(ZERO_BYTE);
+        out[pos] = in[i];
+        pos += 2;
     }
-    // Fill remaining service name
-    const quint16 REMAINING_SERVICE_NAME = 10;
-    Common::fill(bleArray, REMAINING_SERVICE_NAME, ZERO_BYTE);
-    // Reserved
-    bleArray.append(ZERO_BYTE);
     // CTR value
-    bleArray.append(dataArray.right(CTR_VALUE_SIZE));
+    memcpy(out + BLE_PARENT_NODE_SIZE - CTR_VALUE_SIZE, in + dataArray.size() - CTR_VALUE_SIZE, CTR_VALUE_SIZE);
     return bleArray;
 }
 
-QByteArray MPMiniToBleNodeConverter::convertMiniChildNodeToBle(const QByteArray &dataArray)
+QByteArray MPMiniToBleNodeConverter::convertMiniChildNodeToBle(const QByteArray &dataArray) const
 {
+    // The converted node is written in place, unused fields stay zero
+    QByteArray bleArray(BLE_CHILD_NODE_SIZE, ZERO_BYTE);
+    char *out = bleArray.data();
+    const char *in = dataArray.constData();
     // Flags, prev, next parent, first child
-    QByteArray bleArray = dataArray.left(CHILD_ADDRESSES);
-    bleArray[0] = dataArray[0]|(1<<ASCII_FLAG); // Setting ascii flag for child node
+    memcpy(out, in, CHILD_ADDRESSES);
+    out[0] = in[0]|(1<<ASCII_FLAG); // Setting ascii flag for child node
     // Pointed to child
-    Common::fill(bleArray, 2, ZERO_BYTE);
+    int pos = CHILD_ADDRESSES + 2;
     // Last modified/used day
-    bleArray.append(dataArray.mid(MINI_DATES_START_BYTE, DATES_SIZE));
+    memcpy(out + pos, in + MINI_DATES_START_BYTE, DATES_SIZE);
+    pos += DATES_SIZE;
     // Convert login to ascii
     for (int i = MINI_LOGIN_START_BYTE; i < MINI_LOGIN_LAST_BYTE; ++i)
     {
-        bleArray.append(dataArray[i]);
-        bleArray.append(ZERO_BYTE);
+        out[pos] = in[i];
+        pos += 2;
     }
     // Fill remaining login
-    Common::fill(bleArray, 2, ZERO_BYTE);
+    pos += 2;
     // Convert description to ascii
     for (int i = CHILD_ADDRESSES; i < MINI_DESC_LAST_BYTE; ++i)
     {
-        bleArray.append(dataArray[i]);
-        bleArray.append(ZERO_BYTE);
+        out[pos] = in[i];
+        pos += 2;
     }
     // Fill arbitrary third field
-    Common::fill(bleArray, THIRD_FIELD_SIZE, ZERO_BYTE);
+    pos += THIRD_FIELD_SIZE;
     // Key pressed
     const char DEFAULT_CHAR = static_cast<char>(0xFF);
-    Common::fill(bleArray, KEY_PRESSED_SIZE, DEFAULT_CHAR);
+    memset(out + pos, DEFAULT_CHAR, KEY_PRESSED_SIZE);
+    pos += KEY_PRESSED_SIZE;
     // same as flags, but with bit 5 set to 1
-    bleArray.append(bleArray.left(2));
-    bleArray[FLAGS_BYTE_NOT_VALID_SET] = bleArray[FLAGS_BYTE_NOT_VALID_SET]|(1<<FLAGS_NOT_VALID_BIT);
+    out[pos] = out[0];
+    out[pos + 1] = out[1];
+    out[FLAGS_BYTE_NOT_VALID_SET] = out[FLAGS_BYTE_NOT_VALID_SET]|(1<<FLAGS_NOT_VALID_BIT);
+    pos += 2;
     // reserved
-    bleArray.append(ZERO_BYTE);
+    pos += 1;
     // CTR value
-    bleArray.append(dataArray.mid(MINI_CTR_START_BYTE, CTR_VALUE_SIZE));
-    // Encrypted password
-    bleArray.append(dataArray.mid(MINI_PWD_START_BYTE, MINI_PWD_SIZE));
-    const quint16 REMAINING_PASSWORD_SIZE = 96;
-    Common::fill(bleArray, REMAINING_PASSWORD_SIZE, ZERO_BYTE);
-    // password terminating 0
-    Common::fill(bleArray, 2, ZERO_BYTE);
-    // TBD
-    const quint16 TBD_SIZE = 128;
-    Common::fill(bleArray, TBD_SIZE, ZERO_BYTE);
+    memcpy(out + pos, in + MINI_CTR_START_BYTE, CTR_VALUE_SIZE);
+    pos += CTR_VALUE_SIZE;
+    // Encrypted password, remaining password, terminating 0 and TBD are zero
+    memcpy(out + pos, in + MINI_PWD_START_BYTE, MINI_PWD_SIZE);
 
     return bleArray;
 }
@@ -2,16 +2,28 @@
 #define MPMINITOBLENODECONVERTER_H
 
 #include <QByteArray>
+#include <QVector>
 
-
+/**
+ * @brief The MPMiniToBleNodeConverter class
+ * Converts Mini nodes of an export file to the BLE node layout.
+ * Conversion has no state, nodes can be converted from any thread.
+ */
 class MPMiniToBleNodeConverter
 {
 public:
     MPMiniToBleNodeConverter();
-    void convert(QByteArray &dataArray);
+    void convert(QByteArray &dataArray) const;
+    /**
+     * @brief convertAll
+     * Converts every node in parallel on the global thread pool.
+     * @param nodes: Mini nodes, replaced by the converted BLE nodes
+     * @return false if one of the nodes is not a Mini node, nodes are left unchanged
+     */
+    bool convertAll(QVector<QByteArray> &nodes) const;
 private:
-    QByteArray convertMiniParentNodeToBle(const QByteArray& dataArray);
-    QByteArray convertMiniChildNodeToBle(const QByteArray& dataArray);
+    QByteArray convertMiniParentNodeToBle(const QByteArray& dataArray) const;
+    QByteArray convertMiniChildNodeToBle(const QByteArray& dataArray) const;
 
     const static char ZERO_BYTE = static_cast<char>(0x00);
     const static quint16 CHILD_NODE_FLAG = 0x40;
@@ -32,6 +44,8 @@ private:
     const static quint16 MINI_PWD_SIZE = 32;
     const static quint16 FLAGS_BYTE_NOT_VALID_SET = 264;
     const static quint16 THIRD_FIELD_SIZE = 72;
+    const static quint16 BLE_PARENT_NODE_SIZE = 264;
+    const static quint16 BLE_CHILD_NODE_SIZE = 528;
 };
 
 #endif // MPMINITOBLENODECONVERTER_H
@@ -65,6 +65,7 @@ MPNode::MPNode(QObject *parent, QByteArray &&nodeAddress, const quint32 virt_add
 void MPNode::appendData(const QByteArray &d)
 {
     data.append(d);
+    invalidateStrings();
 }
 
 int MPNode::getType() const
@@ -78,9 +79,11 @@ int MPNode::getType() const
 
 void MPNode::setType(const quint8 type)
 {
+    journalChange();
     if (data.size() > 1)
     {
         data[1] = type << 6;
+        invalidateStrings();
     }
 }
 
@@ -89,8 +92,41 @@ QByteArray MPNode::getAddress() const
     return address;
 }
 
+MPNode::Link MPNode::getAddressLink() const
+{
+    return Link::fromAddress(address, virtualAddress);
+}
+
+MPNode::Link MPNode::Link::fromAddress(const QByteArray &addr, const quint32 virt_addr)
+{
+    Link link;
+    if (addr.isNull())
+    {
+        link.isVirtual = true;
+        link.virtualAddress = virt_addr;
+    }
+    else if (addr.size() >= ADDRESS_LENGTH)
+    {
+        link.address = toAddressValue(addr.constData());
+    }
+    return link;
+}
+
+QByteArray MPNode::Link::toAddress() const
+{
+    if (isVirtual)
+    {
+        return QByteArray();
+    }
+    QByteArray addr(ADDRESS_LENGTH, 0);
+    addr[0] = static_cast<char>(address & 0xFF);
+    addr[1] = static_cast<char>(address >> 8);
+    return addr;
+}
+
 void MPNode::setAddress(const QByteArray &d, const quint32 virt_addr)
 {
+    journalChange();
     address = d;
     virtualAddress = virt_addr;
 }
@@ -107,37 +143,37 @@ quint32 MPNode::getVirtualAddress(void) const
 
 void MPNode::setPointedToCheck()
 {
-    pointedToCheck = true;
+    setFlag(POINTED_TO_CHECK);
 }
 
 void MPNode::removePointedToCheck()
 {
-    pointedToCheck = false;
+    clearFlag(POINTED_TO_CHECK);
 }
 
 void MPNode::setNotDeletedTagged()
 {
-    notDeletedTagged = true;
+    setFlag(NOT_DELETED_TAGGED);
 }
 
 bool MPNode::getNotDeletedTagged() const
 {
-    return notDeletedTagged;
+    return hasFlag(NOT_DELETED_TAGGED);
 }
 
 void MPNode::setMergeTagged()
 {
-    mergeTagged = true;
+    setFlag(MERGE_TAGGED);
 }
 
 bool MPNode::getMergeTagged() const
 {
-    return mergeTagged;
+    return hasFlag(MERGE_TAGGED);
 }
 
 bool MPNode::getPointedToCheck() const
 {
-    return pointedToCheck;
+    return hasFlag(POINTED_TO_CHECK);
 }
 
 qint8 MPNode::getFavoriteProperty() const
@@ -163,7 +199,7 @@ void MPNode::setEncDataSize(const quint32 encSize)
 QByteArray MPNode::getPreviousParentAddress() const
 {
     if (!isValid()) return QByteArray();
-    if (prevVirtualAddressSet) return QByteArray();
+    if (hasFlag(PREV_VIRTUAL_ADDRESS_SET)) return QByteArray();
     return data.mid(PREVIOUS_PARENT_ADDR_START, ADDRESS_LENGTH);
 }
 
@@ -174,14 +210,15 @@ quint32 MPNode::getPreviousParentVirtualAddress() const
 
 void MPNode::setPreviousParentAddress(const QByteArray &d, const quint32 virt_addr)
 {
+    journalChange();
     if (d.isNull())
     {
         prevVirtualAddress = virt_addr;
-        prevVirtualAddressSet = true;
+        setFlag(PREV_VIRTUAL_ADDRESS_SET);
     }
     else
     {
-        prevVirtualAddressSet = false;
+        clearFlag(PREV_VIRTUAL_ADDRESS_SET);
         data[PREVIOUS_PARENT_ADDR_START] = d[0];
         data[PREVIOUS_PARENT_ADDR_START+1] = d[1];
     }
@@ -190,7 +227,7 @@ void MPNode::setPreviousParentAddress(const QByteArray &d, const quint32 virt_ad
 QByteArray MPNode::getNextParentAddress() const
 {
     if (!isValid()) return QByteArray();
-    if (nextVirtualAddressSet) return QByteArray();
+    if (hasFlag(NEXT_VIRTUAL_ADDRESS_SET)) return QByteArray();
     return data.mid(NEXT_PARENT_ADDR_START, ADDRESS_LENGTH);
 }
 
@@ -201,14 +238,15 @@ quint32 MPNode::getNextParentVirtualAddress() const
 
 void MPNode::setNextParentAddress(const QByteArray &d, const quint32 virt_addr)
 {
+    journalChange();
     if (d.isNull())
     {
         nextVirtualAddress = virt_addr;
-        nextVirtualAddressSet = true;
+        setFlag(NEXT_VIRTUAL_ADDRESS_SET);
     }
     else
     {
-        nextVirtualAddressSet = false;
+        clearFlag(NEXT_VIRTUAL_ADDRESS_SET);
         data[NEXT_PARENT_ADDR_START] = d[0];
         data[NEXT_PARENT_ADDR_START+1] = d[1];
     }
@@ -217,7 +255,7 @@ void MPNode::setNextParentAddress(const QByteArray &d, const quint32 virt_addr)
 QByteArray MPNode::getStartChildAddress() const
 {
     if (!isValid()) return QByteArray();
-    if (firstChildVirtualAddressSet) return QByteArray();
+    if (hasFlag(FIRST_CHILD_VIRTUAL_ADDRESS_SET)) return QByteArray();
     return data.mid(START_CHILD_ADDR_START, ADDRESS_LENGTH);
 }
 
@@ -228,14 +266,15 @@ quint32 MPNode::getStartChildVirtualAddress() const
 
 void MPNode::setStartChildAddress(const QByteArray &d, const quint32 virt_addr)
 {
+    journalChange();
     if (d.isNull())
     {
         firstChildVirtualAddress = virt_addr;
-        firstChildVirtualAddressSet = true;
+        setFlag(FIRST_CHILD_VIRTUAL_ADDRESS_SET);
     }
     else
     {
-        firstChildVirtualAddressSet = false;
+        clearFlag(FIRST_CHILD_VIRTUAL_ADDRESS_SET);
         data[START_CHILD_ADDR_START] = d[0];
         data[START_CHILD_ADDR_START+1] = d[1];
     }
@@ -244,7 +283,7 @@ void MPNode::setStartChildAddress(const QByteArray &d, const quint32 virt_addr)
 QByteArray MPNode::getNextChildAddress() const
 {
     if (!isValid()) return QByteArray();
-    if (nextVirtualAddressSet) return QByteArray();
+    if (hasFlag(NEXT_VIRTUAL_ADDRESS_SET)) return QByteArray();
     return data.mid(NEXT_PARENT_ADDR_START, ADDRESS_LENGTH);
 }
 
@@ -255,14 +294,15 @@ quint32 MPNode::getNextChildVirtualAddress(void) const
 
 void MPNode::setNextChildAddress(const QByteArray &d, const quint32 virt_addr)
 {
+    journalChange();
     if (d.isNull())
     {
         nextVirtualAddress = virt_addr;
-        nextVirtualAddressSet = true;
+        setFlag(NEXT_VIRTUAL_ADDRESS_SET);
     }
     else
     {
-        nextVirtualAddressSet = false;
+        clearFlag(NEXT_VIRTUAL_ADDRESS_SET);
         data[NEXT_PARENT_ADDR_START] = d[0];
         data[NEXT_PARENT_ADDR_START+1] = d[1];
     }
@@ -276,20 +316,21 @@ quint32  MPNode::getPreviousChildVirtualAddress(void) const
 QByteArray MPNode::getPreviousChildAddress() const
 {
     if (!isValid()) return QByteArray();
-    if (prevVirtualAddressSet) return QByteArray();
+    if (hasFlag(PREV_VIRTUAL_ADDRESS_SET)) return QByteArray();
     return data.mid(PREVIOUS_PARENT_ADDR_START, ADDRESS_LENGTH);
 }
 
 void MPNode::setPreviousChildAddress(const QByteArray &d, const quint32 virt_addr)
 {
+    journalChange();
     if (d.isNull())
     {
         prevVirtualAddress = virt_addr;
-        prevVirtualAddressSet = true;
+        setFlag(PREV_VIRTUAL_ADDRESS_SET);
     }
     else
     {
-        prevVirtualAddressSet = false;
+        clearFlag(PREV_VIRTUAL_ADDRESS_SET);
         data[PREVIOUS_PARENT_ADDR_START] = d[0];
         data[PREVIOUS_PARENT_ADDR_START+1] = d[1];
     }
@@ -298,20 +339,21 @@ void MPNode::setPreviousChildAddress(const QByteArray &d, const quint32 virt_add
 QByteArray MPNode::getNextChildDataAddress() const
 {
     if (!isValid()) return QByteArray();
-    if (nextVirtualAddressSet) return QByteArray();
+    if (hasFlag(NEXT_VIRTUAL_ADDRESS_SET)) return QByteArray();
     return data.mid(NEXT_DATA_ADDR_START, ADDRESS_LENGTH);
 }
 
 void MPNode::setNextChildDataAddress(const QByteArray &d, const quint32 virt_addr)
 {
+    journalChange();
     if (d.isNull())
     {
         nextVirtualAddress = virt_addr;
-        nextVirtualAddressSet = true;
+        setFlag(NEXT_VIRTUAL_ADDRESS_SET);
     }
     else
     {
-        nextVirtualAddressSet = false;
+        clearFlag(NEXT_VIRTUAL_ADDRESS_SET);
         data[NEXT_DATA_ADDR_START] = d[0];
         data[NEXT_DATA_ADDR_START+1] = d[1];
     }
@@ -343,11 +385,13 @@ QByteArray MPNode::getLoginNodeData() const
 
 void MPNode::setLoginNodeData(const QByteArray &flags, const QByteArray &d)
 {
+    journalChange();
     // overwrite core data, excluding linked lists
     if (isValid())
     {
         data.replace(DATA_ADDR_START, pMesProt->getParentNodeSize()-DATA_ADDR_START, d);
         data.replace(0, ADDRESS_LENGTH, flags);
+        invalidateStrings();
     }
 }
 
@@ -360,11 +404,13 @@ QByteArray MPNode::getLoginChildNodeData() const
 
 void MPNode::setLoginChildNodeData(const QByteArray &flags, const QByteArray &d)
 {
+    journalChange();
     // overwrite core data, excluding linked lists
     if (isValid())
     {
         data.replace(LOGIN_CHILD_NODE_DATA_ADDR_START, pMesProt->getChildNodeSize()-LOGIN_CHILD_NODE_DATA_ADDR_START, d);
         data.replace(0, ADDRESS_LENGTH, flags);
+        invalidateStrings();
     }
 }
 
@@ -376,11 +422,13 @@ QByteArray MPNode::getDataNodeData() const
 
 void MPNode::setDataNodeData(const QByteArray &flags, const QByteArray &d)
 {
+    journalChange();
     // overwrite core data, excluding linked lists
     if (isValid())
     {
         data.replace(DATA_ADDR_START, pMesProt->getParentNodeSize()-DATA_ADDR_START, d);
         data.replace(0, ADDRESS_LENGTH, flags);
+        invalidateStrings();
     }
 }
 
@@ -392,14 +440,123 @@ QByteArray MPNode::getDataChildNodeData() const
 
 void MPNode::setDataChildNodeData(const QByteArray &flags, const QByteArray &d)
 {
+    journalChange();
     // overwrite core data, excluding linked lists
     if (isValid())
     {
         data.replace(DATA_CHILD_DATA_ADDR_START, pMesProt->getChildNodeSize()-DATA_CHILD_DATA_ADDR_START, d);
         data.replace(0, ADDRESS_LENGTH, flags);
+        invalidateStrings();
     }
 }
 
+QString MPNode::getService() const
+{
+    if (!hasFlag(SERVICE_CACHED))
+    {
+        cachedService = decodeService();
+        setFlag(SERVICE_CACHED);
+    }
+    return cachedService;
+}
+
+void MPNode::setService(const QString &service)
+{
+    journalChange();
+    encodeService(service);
+    invalidateStrings();
+}
+
+QString MPNode::getLogin() const
+{
+    if (!hasFlag(LOGIN_CACHED))
+    {
+        cachedLogin = decodeLogin();
+        setFlag(LOGIN_CACHED);
+    }
+    return cachedLogin;
+}
+
+void MPNode::setLogin(const QString &newLogin)
+{
+    journalChange();
+    encodeLogin(newLogin);
+    invalidateStrings();
+}
+
+void MPNode::shareData(const MPNode &other)
+{
+    data = other.data;
+    invalidateStrings();
+}
+
+void MPNode::ChangeJournal::recordChange(MPNode *node)
+{
+    if (index.contains(node))
+    {
+        return;
+    }
+    Entry entry;
+    entry.node = node;
+    entry.type = node->getType();
+    entry.data = node->data;
+    entry.address = node->address;
+    index.insert(node, entries.size());
+    entries.append(entry);
+}
+
+void MPNode::ChangeJournal::recordAdded(MPNode *node)
+{
+    attach(node);
+    if (index.contains(node))
+    {
+        return;
+    }
+    Entry entry;
+    entry.node = node;
+    entry.type = node->getType();
+    index.insert(node, entries.size());
+    entries.append(entry);
+}
+
+void MPNode::ChangeJournal::recordRemoved(MPNode *node)
+{
+    if (node->changeJournal != this)
+    {
+        return;
+    }
+    node->changeJournal = nullptr;
+
+    Entry removed;
+    auto it = index.find(node);
+    if (it == index.end())
+    {
+        removed.type = node->getType();
+        removed.data = node->data;
+        removed.address = node->address;
+    }
+    else
+    {
+        removed = entries[it.value()];
+        entries[it.value()].node = nullptr;
+        index.erase(it);
+    }
+
+    //Nodes added in MMM were never written to the device
+    if (!removed.address.isNull())
+    {
+        removed.node = nullptr;
+        removedNodes.insert(removed.address, removed);
+    }
+}
+
+void MPNode::ChangeJournal::clear()
+{
+    entries.clear();
+    index.clear();
+    removedNodes.clear();
+}
+
 QJsonObject MPNode::toJson() const
 {
     QJsonObject obj;
@@ -80,14 +80,15 @@ public:
     quint32 getPreviousChildVirtualAddress(void) const;
     QByteArray getPreviousChildAddress() const;
 
-    virtual QString getService() const = 0;
-    virtual void setService(const QString &service) = 0;
+    // Decoded strings are cached until the node data changes
+    QString getService() const;
+    void setService(const QString &service);
     virtual QByteArray getStartDataCtr() const = 0;
     virtual QByteArray getCTR() const = 0;
     virtual QString getDescription() const = 0;
     virtual void setDescription(const QString &newDescription) = 0;
-    virtual QString getLogin() const = 0;
-    virtual void setLogin(const QString &newLogin) = 0;
+    QString getLogin() const;
+    void setLogin(const QString &newLogin);
     virtual QByteArray getPasswordEnc() const = 0;
     virtual QDate getDateCreated() const = 0;
     virtual QDate getDateLastUsed() const = 0;
@@ -105,6 +106,40 @@ public:
     // NodeChildData properties
     QByteArray getNextDataAddress() const;
 
+    /**
+     * @brief The Link struct
+     * Typed view of a node address field, read straight from the node data
+     * without copying it out. A link to a node not written to the device yet
+     * is virtual, like the null QByteArray returned by the address getters.
+     */
+    static constexpr quint16 EMPTY_ADDRESS_VALUE = 0;
+
+    struct Link
+    {
+        quint16 address = EMPTY_ADDRESS_VALUE;
+        quint32 virtualAddress = 0;
+        bool isVirtual = false;
+
+        static Link fromAddress(const QByteArray &addr, const quint32 virt_addr = 0);
+        //A virtual link is never empty, like a null address in the chain walks
+        bool isEmpty() const { return !isVirtual && EMPTY_ADDRESS_VALUE == address; }
+        QByteArray toAddress() const;
+        bool operator==(const Link &other) const
+        {
+            return isVirtual == other.isVirtual &&
+                    (isVirtual ? virtualAddress == other.virtualAddress : address == other.address);
+        }
+        bool operator!=(const Link &other) const { return !(*this == other); }
+    };
+
+    Link getAddressLink() const;
+    Link getPreviousParentLink() const { return readLink(PREVIOUS_PARENT_ADDR_START, PREV_VIRTUAL_ADDRESS_SET, prevVirtualAddress); }
+    Link getNextParentLink() const { return readLink(NEXT_PARENT_ADDR_START, NEXT_VIRTUAL_ADDRESS_SET, nextVirtualAddress); }
+    Link getStartChildLink() const { return readLink(START_CHILD_ADDR_START, FIRST_CHILD_VIRTUAL_ADDRESS_SET, firstChildVirtualAddress); }
+    Link getPreviousChildLink() const { return readLink(PREVIOUS_PARENT_ADDR_START, PREV_VIRTUAL_ADDRESS_SET, prevVirtualAddress); }
+    Link getNextChildLink() const { return readLink(NEXT_PARENT_ADDR_START, NEXT_VIRTUAL_ADDRESS_SET, nextVirtualAddress); }
+    Link getNextChildDataLink() const { return readLink(NEXT_DATA_ADDR_START, NEXT_VIRTUAL_ADDRESS_SET, nextVirtualAddress); }
+
     // Node properties
     QByteArray getNodeData() const;
     QByteArray getNodeFlags() const;
@@ -135,30 +170,97 @@ public:
     static QByteArray EmptyAddress;
     static constexpr int ADDRESS_LENGTH = 2;
 
+    /**
+     * @brief shareData
+     * Make this node a snapshot of other: the node data is
+     * implicitly shared and only copied when one of them is modified.
+     * Used for the clone nodes kept while in MMM.
+     */
+    void shareData(const MPNode &other);
+
+    /**
+     * @brief The ChangeJournal struct
+     * MMM changes recorded when they are made: the device data and address
+     * of each node before its first change, and the removed nodes.
+     * Save packets are generated from it instead of diffing the clones.
+     */
+    struct ChangeJournal
+    {
+        struct Entry
+        {
+            MPNode *node = nullptr;
+            int type = NodeUnknown;
+            //Data and address on the device, null for a node added in MMM
+            QByteArray data;
+            QByteArray address;
+        };
+
+        //Changed nodes in the order of their first change
+        QVector<Entry> entries;
+        QHash<MPNode *, int> index;
+        //Removed nodes by device address
+        QMap<QByteArray, Entry> removedNodes;
+
+        void attach(MPNode *node) { node->changeJournal = this; }
+        void recordChange(MPNode *node);
+        void recordAdded(MPNode *node);
+        void recordRemoved(MPNode *node);
+        void clear();
+    };
+
     QJsonObject toJson() const;
 
 protected:
     IMessageProtocol* getMesProt(QObject *parent);
 
+    virtual QString decodeService() const = 0;
+    virtual void encodeService(const QString &service) = 0;
+    virtual QString decodeLogin() const = 0;
+    virtual void encodeLogin(const QString &login) = 0;
+
+    void invalidateStrings() { clearFlag(SERVICE_CACHED | LOGIN_CACHED); }
+    //Called before the node data or address is modified
+    void journalChange() { if (changeJournal) changeJournal->recordChange(this); }
+
+    static quint16 toAddressValue(const char *addr)
+    {
+        return static_cast<quint16>(static_cast<quint8>(addr[0]) | (static_cast<quint8>(addr[1]) << 8));
+    }
+    inline Link readLink(int offset, quint8 virtualFlag, quint32 virt_addr) const;
+
+    enum NodeFlag : quint8
+    {
+        MERGE_TAGGED                    = 0x01,
+        POINTED_TO_CHECK                = 0x02,
+        NOT_DELETED_TAGGED              = 0x04,
+        FIRST_CHILD_VIRTUAL_ADDRESS_SET = 0x08,
+        NEXT_VIRTUAL_ADDRESS_SET        = 0x10,
+        PREV_VIRTUAL_ADDRESS_SET        = 0x20,
+        SERVICE_CACHED                  = 0x40,
+        LOGIN_CACHED                    = 0x80
+    };
+    inline bool hasFlag(quint8 flag) const { return (nodeFlags & flag) != 0; }
+    inline void setFlag(quint8 flag) const { nodeFlags |= flag; }
+    inline void clearFlag(quint8 flag) const { nodeFlags &= static_cast<quint8>(~flag); }
+
     QByteArray data;
     QByteArray address;
-    bool mergeTagged = false;
-    bool pointedToCheck = false;
-    bool notDeletedTagged = false;
-    bool firstChildVirtualAddressSet = false;
+    mutable quint8 nodeFlags = 0;
+    qint8 favorite = Common::FAV_NOT_SET;
     quint32 firstChildVirtualAddress = 0;
-    bool nextVirtualAddressSet = false;
     quint32 nextVirtualAddress = 0;
-    bool prevVirtualAddressSet = false;
     quint32 prevVirtualAddress = 0;
     quint32 virtualAddress = 0;
     quint32 encDataSize = 0;
-    qint8 favorite = Common::FAV_NOT_SET;
+
+    mutable QString cachedService;
+    mutable QString cachedLogin;
 
     QList<MPNode *> childNodes;
     QList<MPNode *> childDataNodes;
 
     IMessageProtocol *pMesProt = nullptr;
+    ChangeJournal *changeJournal = nullptr;
     const bool isBLE = false;
 
     static constexpr int CTR_LENGTH = 3;
@@ -176,4 +278,19 @@ protected:
     static constexpr int SERVICE_ADDR_START = 8;
 };
 
+MPNode::Link MPNode::readLink(int offset, quint8 virtualFlag, quint32 virt_addr) const
+{
+    Link link;
+    if (!isValid() || hasFlag(virtualFlag))
+    {
+        link.isVirtual = true;
+        link.virtualAddress = virt_addr;
+    }
+    else
+    {
+        link.address = toAddressValue(data.constData() + offset);
+    }
+    return link;
+}
+
 #endif // MPNODE_H
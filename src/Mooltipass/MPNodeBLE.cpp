@@ -26,6 +26,13 @@ bool MPNodeBLE::isDataLengthValid() const
     return isValid();
 }
 
+QByteArray MPNodeBLE::rawField(int start, int length) const
+{
+    //Strings are decoded right away, no need to copy the node data
+    const int available = qBound(0, data.size() - start, length);
+    return QByteArray::fromRawData(data.constData() + qMin(start, data.size()), available);
+}
+
 bool MPNodeBLE::isValid() const
 {
     const auto type = getType();
@@ -38,13 +45,13 @@ bool MPNodeBLE::isValid() const
            (data.size() == CHILD_NODE_LENGTH && (NodeChild == type || NodeChildData == type));
 }
 
-QString MPNodeBLE::getService() const
+QString MPNodeBLE::decodeService() const
 {
     if (!isValid()) return QString();
-    return pMesProt->toQString(data.mid(SERVICE_ADDR_START, SERVICE_LENGTH));
+    return pMesProt->toQString(rawField(SERVICE_ADDR_START, SERVICE_LENGTH));
 }
 
-void MPNodeBLE::setService(const QString &service)
+void MPNodeBLE::encodeService(const QString &service)
 {
     if (isValid())
     {
@@ -71,11 +78,12 @@ QByteArray MPNodeBLE::getCTR() const
 QString MPNodeBLE::getDescription() const
 {
     if (!isValid()) return QString();
-    return pMesProt->toQString(data.mid(DESC_ADDR_START, DESC_LENGTH));
+    return pMesProt->toQString(rawField(DESC_ADDR_START, DESC_LENGTH));
 }
 
 void MPNodeBLE::setDescription(const QString &newDescription)
 {
+    journalChange();
     if (isValid())
     {
         QByteArray desc = pMesProt->toByteArray(newDescription);
@@ -86,13 +94,13 @@ void MPNodeBLE::setDescription(const QString &newDescription)
     }
 }
 
-QString MPNodeBLE::getLogin() const
+QString MPNodeBLE::decodeLogin() const
 {
     if (!isValid()) return QString();
-    return pMesProt->toQString(data.mid(LOGIN_ADDR_START, LOGIN_LENGTH));
+    return pMesProt->toQString(rawField(LOGIN_ADDR_START, LOGIN_LENGTH));
 }
 
-void MPNodeBLE::setLogin(const QString &newLogin)
+void MPNodeBLE::encodeLogin(const QString &newLogin)
 {
     if (isValid())
     {
@@ -159,6 +167,7 @@ int MPNodeBLE::getCategory() const
 
 void MPNodeBLE::setCategory(int category)
 {
+    journalChange();
     quint8 categoryBit = data[0]&0x0F0;
     if (category > 0)
     {
@@ -175,6 +184,7 @@ int MPNodeBLE::getKeyAfterLogin() const
 
 void MPNodeBLE::setKeyAfterLogin(int key)
 {
+    journalChange();
     if (isValid())
     {
         const auto keyArray = pMesProt->toLittleEndianFromInt(key);
@@ -191,6 +201,7 @@ int MPNodeBLE::getKeyAfterPwd() const
 
 void MPNodeBLE::setKeyAfterPwd(int key)
 {
+    journalChange();
     if (isValid())
     {
         const auto keyArray = pMesProt->toLittleEndianFromInt(key);
@@ -207,6 +218,7 @@ int MPNodeBLE::getPwdBlankFlag() const
 
 void MPNodeBLE::setPwdBlankFlag()
 {
+    journalChange();
     if (isValid())
     {
         data[PWD_BLANK_FLAG] = static_cast<char>(BLANK_CHAR);
@@ -37,13 +37,13 @@ bool MPNodeMini::isValid() const
             (static_cast<quint8>(data[1]) & 0x20) == 0;
 }
 
-QString MPNodeMini::getService() const
+QString MPNodeMini::decodeService() const
 {
     if (!isValid()) return QString();
     return pMesProt->toQString(data.mid(SERVICE_ADDR_START, MP_NODE_SIZE - 8 - 3));
 }
 
-void MPNodeMini::setService(const QString &service)
+void MPNodeMini::encodeService(const QString &service)
 {
     if (isValid())
     {
@@ -75,6 +75,7 @@ QString MPNodeMini::getDescription() const
 
 void MPNodeMini::setDescription(const QString &newDescription)
 {
+    journalChange();
     if (isValid())
     {
         QByteArray desc = pMesProt->toByteArray(newDescription);
@@ -85,13 +86,13 @@ void MPNodeMini::setDescription(const QString &newDescription)
     }
 }
 
-QString MPNodeMini::getLogin() const
+QString MPNodeMini::decodeLogin() const
 {
     if (!isValid()) return QString();
     return pMesProt->toQString(data.mid(LOGIN_ADDR_START, LOGIN_LENGTH));
 }
 
-void MPNodeMini::setLogin(const QString &newLogin)
+void MPNodeMini::encodeLogin(const QString &newLogin)
 {
     if (isValid())
     {
@@ -16,19 +16,20 @@ public:
     bool isDataLengthValid() const override;
     bool isValid() const override;
 
-    QString getService() const override;
-    void setService(const QString& service) override;
     QByteArray getStartDataCtr() const override;
     QByteArray getCTR() const override;
     QString getDescription() const override;
     void setDescription(const QString& newDescription) override;
-    QString getLogin() const override;
-    void setLogin(const QString& newLogin) override;
     QByteArray getPasswordEnc() const override;
     QDate getDateCreated() const override;
     QDate getDateLastUsed() const override;
 
 protected:
+    QString decodeService() const override;
+    void encodeService(const QString& service) override;
+    QString decodeLogin() const override;
+    void encodeLogin(const QString& newLogin) override;
+
     static constexpr int CTR_DATA_ADDR_START = 129;
     static constexpr int CTR_ADDR_START = 34;
     static constexpr int DESC_ADDR_START = 6;
@@ -93,12 +93,16 @@ void MPSettingsBLE::loadParameters()
 
     connect(jobs, &AsyncJobs::finished, [this](const QByteArray &)
     {
+        m_readingParams = false;
+        m_paramsLoaded = true;
+        applyPendingParams();
         //Sending every param when fetched first time
         if (!m_everyParamSent)
         {
             sendEveryParameter();
             m_everyParamSent = true;
         }
+        saveCachedParameters(mpDevice->get_serialNumber());
     });
 
     mpDevice->enqueueAndRunJob(jobs);
@@ -107,6 +111,12 @@ void MPSettingsBLE::loadParameters()
 
 void MPSettingsBLE::updateParam(MPParams::Param param, int val)
 {
+    if (!m_paramsLoaded)
+    {
+        m_pendingParams[param] = val;
+        return;
+    }
+
     if (m_bleByteMapping.contains(param))
     {
         if (MPParams::MINI_KNOCK_THRES_PARAM == param)
@@ -121,6 +131,27 @@ void MPSettingsBLE::updateParam(MPParams::Param param, int val)
     }
 }
 
+void MPSettingsBLE::applyPendingParams()
+{
+    if (m_pendingParams.isEmpty())
+    {
+        return;
+    }
+
+    qDebug() << "Applying" << m_pendingParams.size() << "parameter changes on the device settings";
+    for (auto it = m_pendingParams.constBegin(); it != m_pendingParams.constEnd(); ++it)
+    {
+        updateParam(it.key(), it.value());
+    }
+    m_pendingParams.clear();
+
+    if (m_settingsWritePending)
+    {
+        m_settingsWritePending = false;
+        setSettings();
+    }
+}
+
 void MPSettingsBLE::connectSendParams(QObject *slotObject)
 {
     DeviceSettings::connectSendParams(slotObject);
@@ -129,6 +160,13 @@ void MPSettingsBLE::connectSendParams(QObject *slotObject)
 
 void MPSettingsBLE::setSettings()
 {
+    if (!m_paramsLoaded)
+    {
+        qDebug() << "Device settings not read yet, delaying the parameter change";
+        m_settingsWritePending = true;
+        return;
+    }
+
     AsyncJobs *jobs = new AsyncJobs(
                           "Setting device parameters",
                           this);
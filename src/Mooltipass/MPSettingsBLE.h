@@ -22,12 +22,18 @@ private slots:
 
 private:
     void connectSendParams(QObject* slotObject) override;
+    void applyPendingParams();
 
     MPDevice* mpDevice = nullptr;
     IMessageProtocol* pMesProt = nullptr;
     bool m_everyParamSent = false;
 
     QByteArray m_lastDeviceSettings;
+
+    //Changes received before the settings were read from the device,
+    //the cached parameters are only displayed and never written back
+    QMap<MPParams::Param, int> m_pendingParams;
+    bool m_settingsWritePending = false;
 };
 
 #endif // MPSETTINGSBLE_H
@@ -19,7 +19,7 @@ void MPSettingsMini::loadParameters()
 
     jobs->append(new MPCommandJob(mpDevice,
                                   MPCmd::VERSION,
-                                  [this](const QByteArray &data, bool &) -> bool
+                                  [this, jobs](const QByteArray &data, bool &) -> bool
     {
         const auto flashSize = pMesProt->getFirstPayloadByte(data);
         qDebug() << "received MP version FLASH size: " << flashSize << "Mb";
@@ -41,6 +41,22 @@ void MPSettingsMini::loadParameters()
             }
         }
 
+        if (mpDevice->isFw12() && mpDevice->isMini())
+        {
+            qInfo() << "Mini firmware above v1.2, requesting serial number";
+
+            /* Query serial number first, cached parameters are used until the others are read */
+            jobs->prepend(new MPCommandJob(mpDevice,
+                                           MPCmd::GET_SERIAL,
+                                           [this](const QByteArray &data, bool &) -> bool
+            {
+                const auto serialNumber = pMesProt->getSerialNumber(data);
+                mpDevice->set_serialNumber(serialNumber);
+                qDebug() << "Mooltipass Mini serial number:" << serialNumber;
+                return true;
+            }));
+        }
+
         return true;
     }));
 
@@ -286,42 +302,8 @@ void MPSettingsMini::loadParameters()
         //data is last result
         //all jobs finished success
         qInfo() << "Finished loading device options";
-
-        if (mpDevice->isFw12() && mpDevice->isMini())
-        {
-            qInfo() << "Mini firmware above v1.2, requesting serial number";
-
-            AsyncJobs* v12jobs = new AsyncJobs("Loading device serial number", this);
-
-            /* Query serial number */
-            v12jobs->append(new MPCommandJob(mpDevice,
-                                          MPCmd::GET_SERIAL,
-                                          [this](const QByteArray &data, bool &) -> bool
-            {
-                const auto serialNumber = pMesProt->getSerialNumber(data);
-                mpDevice->set_serialNumber(serialNumber);
-                qDebug() << "Mooltipass Mini serial number:" << serialNumber;
-                return true;
-            }));
-
-            connect(v12jobs, &AsyncJobs::finished, [this](const QByteArray &data)
-            {
-                Q_UNUSED(data);
-                //data is last result
-                //all jobs finished success
-                m_readingParams = false;
-                qInfo() << "Finished loading Mini serial number";
-            });
-
-            connect(v12jobs, &AsyncJobs::failed, [this](AsyncJob *failedJob)
-            {
-                Q_UNUSED(failedJob);
-                qCritical() << "Loading Mini serial number failed";
-                m_readingParams = false;
-                loadParameters(); // memory: does it get "piled on?"
-            });
-            mpDevice->enqueueAndRunJob(v12jobs);
-        }
+        m_readingParams = false;
+        saveCachedParameters(mpDevice->get_serialNumber());
     });
 
     connect(jobs, &AsyncJobs::failed, [this](AsyncJob *failedJob)
@@ -0,0 +1,217 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Moolticute; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "PasswordAudit.h"
+#include "Common.h"
+#include "zxcvbn.h"
+
+#include <QtConcurrent/QtConcurrent>
+#include <QCryptographicHash>
+#include <QFutureWatcher>
+#include <QSet>
+#include <random>
+
+constexpr double PasswordAudit::WEAK_ENTROPY;
+
+PasswordAudit::PasswordAudit(int total, int staleDays, QObject *parent):
+    QObject(parent),
+    total(total),
+    staleDays(staleDays)
+{
+    std::vector<qint64> seed = Common::getRngSeed();
+    std::seed_seq seq(seed.begin(), seed.end());
+    std::mt19937 generator(seq);
+    std::uniform_int_distribution<int> distribution(0, 255);
+
+    salt.resize(SALT_SIZE);
+    for (int i = 0; i < SALT_SIZE; ++i)
+        salt[i] = static_cast<char>(distribution(generator));
+}
+
+QString PasswordAudit::loosePassword(const QString &password)
+{
+    //"Summer2019!" and "summer2020" are reported as similar
+    QString loose;
+    loose.reserve(password.size());
+    for (QChar c : password)
+    {
+        if (c.isLetter())
+            loose.append(c.toLower());
+    }
+    return loose;
+}
+
+PasswordAudit::Score PasswordAudit::scorePassword(const QString &password, const QByteArray &salt)
+{
+    Score score;
+    const QByteArray utf8 = password.toUtf8();
+    score.entropy = ZxcvbnMatch(utf8.constData(), nullptr, nullptr);
+    score.length = password.size();
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(salt);
+    hash.addData(utf8);
+    score.digest = hash.result();
+
+    const QString loose = loosePassword(password);
+    if (loose.size() >= LOOSE_MIN_LENGTH)
+    {
+        hash.reset();
+        hash.addData(salt);
+        hash.addData(loose.toUtf8());
+        score.looseDigest = hash.result();
+    }
+    return score;
+}
+
+void PasswordAudit::addPassword(const Credential &cred, const QString &password)
+{
+    //The password is only captured by the worker, the watcher
+    //gets back the score
+    auto future = QtConcurrent::run(&PasswordAudit::scorePassword, password, salt);
+
+    auto *watcher = new QFutureWatcher<Score>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, cred]()
+    {
+        const Score score = watcher->result();
+        watcher->deleteLater();
+        addScore(cred, score);
+    });
+    watcher->setFuture(future);
+}
+
+void PasswordAudit::addFailure(const Credential &cred, const QString &errstr)
+{
+    ++failed;
+    ++done;
+    emit resultReady(QJsonObject{{ "index", cred.index },
+                                 { "service", cred.service },
+                                 { "login", cred.login },
+                                 { "success", false },
+                                 { "error_message", errstr }});
+    checkFinished();
+}
+
+void PasswordAudit::addScore(const Credential &cred, const Score &score)
+{
+    QJsonObject res = {{ "index", cred.index },
+                       { "service", cred.service },
+                       { "login", cred.login },
+                       { "success", true },
+                       { "entropy", score.entropy },
+                       { "length", score.length },
+                       { "weak", score.entropy < WEAK_ENTROPY }};
+
+    //Only report credentials already scored, later ones will
+    //point back to this one
+    QList<int> &same = reused[score.digest];
+    if (!same.isEmpty())
+    {
+        QJsonArray reusedWith;
+        for (int i : same)
+            reusedWith.append(i);
+        res["reused_with"] = reusedWith;
+    }
+    same.append(cred.index);
+    digestByIndex.insert(cred.index, score.digest);
+
+    if (!score.looseDigest.isEmpty())
+    {
+        QList<int> &close = similar[score.looseDigest];
+        QJsonArray similarTo;
+        for (int i : close)
+        {
+            if (!same.contains(i))
+                similarTo.append(i);
+        }
+        if (!similarTo.isEmpty())
+            res["similar_to"] = similarTo;
+        close.append(cred.index);
+    }
+
+    const QDate today = QDate::currentDate();
+    bool isStale = false;
+    if (cred.dateCreated.isValid())
+        res["days_since_created"] = cred.dateCreated.daysTo(today);
+    if (cred.dateLastUsed.isValid())
+    {
+        const qint64 unused = cred.dateLastUsed.daysTo(today);
+        res["days_since_last_used"] = unused;
+        isStale = unused > staleDays;
+    }
+    res["stale"] = isStale;
+
+    if (score.entropy < WEAK_ENTROPY)
+        ++weak;
+    if (isStale)
+        ++stale;
+    ++done;
+
+    emit resultReady(res);
+    checkFinished();
+}
+
+QJsonArray PasswordAudit::groupsToJson(const QHash<QByteArray, QList<int>> &groups)
+{
+    QJsonArray arr;
+    for (const QList<int> &group : groups)
+    {
+        if (group.size() < 2)
+            continue;
+
+        QJsonArray indexes;
+        for (int i : group)
+            indexes.append(i);
+        arr.append(indexes);
+    }
+    return arr;
+}
+
+void PasswordAudit::checkFinished()
+{
+    if (done < total)
+        return;
+
+    //Similar groups also contain exact reuse, keep the ones
+    //with at least two different passwords
+    QHash<QByteArray, QList<int>> similarOnly;
+    for (auto it = similar.constBegin(); it != similar.constEnd(); ++it)
+    {
+        QSet<QByteArray> digests;
+        for (int i : it.value())
+            digests.insert(digestByIndex.value(i));
+        if (digests.size() > 1)
+            similarOnly.insert(it.key(), it.value());
+    }
+
+    QJsonObject summary = {{ "total", total },
+                           { "scored", total - failed },
+                           { "failed", failed },
+                           { "weak", weak },
+                           { "stale", stale },
+                           { "reused_groups", groupsToJson(reused) },
+                           { "similar_groups", groupsToJson(similarOnly) }};
+
+    //The salt is not needed anymore
+    salt.fill(0);
+    reused.clear();
+    similar.clear();
+    digestByIndex.clear();
+
+    emit finished(summary);
+}
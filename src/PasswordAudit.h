@@ -0,0 +1,93 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Moolticute; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef PASSWORDAUDIT_H
+#define PASSWORDAUDIT_H
+
+#include <QObject>
+#include <QDate>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+
+/**
+ * @brief The PasswordAudit class
+ * Scores a set of credentials (zxcvbn entropy, reuse, age) for the
+ * security report. Passwords are handed over one by one as they are
+ * fetched from the device, scored on the global thread pool and only
+ * a salted digest is kept afterwards. Reuse is detected by comparing
+ * those digests, the salt is random and only lives as long as the audit.
+ */
+class PasswordAudit: public QObject
+{
+    Q_OBJECT
+public:
+    struct Credential
+    {
+        int index = 0;
+        QString service;
+        QString login;
+        QDate dateCreated;
+        QDate dateLastUsed;
+    };
+
+    struct Score
+    {
+        double entropy = 0;
+        int length = 0;
+        QByteArray digest;
+        //Digest of the letters only, lowercased. Empty for short passwords
+        QByteArray looseDigest;
+    };
+
+    PasswordAudit(int total, int staleDays, QObject *parent = nullptr);
+
+    void addPassword(const Credential &cred, const QString &password);
+    void addFailure(const Credential &cred, const QString &errstr);
+
+    static Score scorePassword(const QString &password, const QByteArray &salt);
+    static QString loosePassword(const QString &password);
+
+    static constexpr double WEAK_ENTROPY = 35;
+    static constexpr int LOOSE_MIN_LENGTH = 4;
+    static constexpr int SALT_SIZE = 32;
+
+signals:
+    /* One per credential, in completion order */
+    void resultReady(const QJsonObject &result);
+    void finished(const QJsonObject &summary);
+
+private:
+    void addScore(const Credential &cred, const Score &score);
+    void checkFinished();
+    static QJsonArray groupsToJson(const QHash<QByteArray, QList<int>> &groups);
+
+    QByteArray salt;
+    int total;
+    int staleDays;
+    int done = 0;
+    int failed = 0;
+    int weak = 0;
+    int stale = 0;
+
+    QHash<QByteArray, QList<int>> reused;
+    QHash<QByteArray, QList<int>> similar;
+    QHash<int, QByteArray> digestByIndex;
+};
+
+#endif // PASSWORDAUDIT_H
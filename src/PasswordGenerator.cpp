@@ -0,0 +1,126 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Moolticute; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include "PasswordGenerator.h"
+#include "zxcvbn.h"
+
+#include <QtConcurrent/QtConcurrent>
+#include <QFutureWatcher>
+#include <random>
+
+std::vector<char> PasswordGenerator::poolFromProfile(const QJsonObject &profile)
+{
+    std::vector<char> pool;
+    if (profile["use_uppercase"].toBool())
+    {
+        for (char c = 'A'; c <= 'Z'; ++c)
+            pool.push_back(c);
+    }
+    if (profile["use_lowercase"].toBool())
+    {
+        for (char c = 'a'; c <= 'z'; ++c)
+            pool.push_back(c);
+    }
+    if (profile["use_digits"].toBool())
+    {
+        for (char c = '0'; c <= '9'; ++c)
+            pool.push_back(c);
+    }
+    if (profile["use_symbols"].toBool())
+    {
+        for (QChar c : profile["symbols"].toString())
+        {
+            //Only printable ascii symbols can be typed by the device
+            if (c.unicode() > 0x20 && c.unicode() < 0x7F && !c.isLetterOrNumber())
+                pool.push_back(c.toLatin1());
+        }
+    }
+    return pool;
+}
+
+namespace {
+struct ChunkJob
+{
+    typedef QVector<GeneratedPassword> result_type;
+
+    std::vector<char> pool;
+    int length;
+    int count;
+    std::vector<qint64> seed;
+
+    QVector<GeneratedPassword> operator()(int chunk) const
+    {
+        const int chunkSize = PasswordGenerator::CHUNK_SIZE;
+        return PasswordGenerator::generateChunk(pool, length, qMin(chunkSize, count - chunk * chunkSize), seed, chunk);
+    }
+};
+}
+
+QVector<GeneratedPassword> PasswordGenerator::generateChunk(const std::vector<char> &pool, int length, int count,
+                                                            const std::vector<qint64> &seed, int chunk)
+{
+    std::vector<qint64> chunkSeed = seed;
+    chunkSeed.push_back(chunk);
+    std::seed_seq seq(chunkSeed.begin(), chunkSeed.end());
+    std::mt19937 generator(seq);
+    std::uniform_int_distribution<int> distribution(0, static_cast<int>(pool.size()) - 1);
+
+    QVector<GeneratedPassword> passwords;
+    passwords.reserve(count);
+    QByteArray result(length, Qt::Uninitialized);
+    for (int i = 0; i < count; ++i)
+    {
+        for (int j = 0; j < length; ++j)
+            result[j] = pool[static_cast<size_t>(distribution(generator))];
+
+        GeneratedPassword p;
+        p.password = QString::fromLatin1(result);
+        p.entropy = ZxcvbnMatch(result.constData(), nullptr, nullptr);
+        passwords.append(p);
+    }
+    return passwords;
+}
+
+void PasswordGenerator::generate(const std::vector<char> &pool, int length, int count,
+                                 const std::vector<qint64> &seed,
+                                 QObject *context, PasswordGeneratorCb cb)
+{
+    if (pool.empty() || length <= 0 || count <= 0)
+    {
+        cb(QVector<GeneratedPassword>());
+        return;
+    }
+
+    QList<int> chunks;
+    for (int i = 0; i * CHUNK_SIZE < count; ++i)
+        chunks.append(i);
+
+    auto future = QtConcurrent::mapped(chunks, ChunkJob{pool, length, count, seed});
+
+    auto *watcher = new QFutureWatcher<QVector<GeneratedPassword>>(context);
+    QObject::connect(watcher, &QFutureWatcherBase::finished, context, [watcher, cb]()
+    {
+        //Results are ordered by chunk
+        QVector<GeneratedPassword> passwords;
+        for (const auto &chunk : watcher->future().results())
+            passwords += chunk;
+        watcher->deleteLater();
+        cb(passwords);
+    });
+    watcher->setFuture(future);
+}
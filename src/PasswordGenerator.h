@@ -0,0 +1,66 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Moolticute; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#ifndef PASSWORDGENERATOR_H
+#define PASSWORDGENERATOR_H
+
+#include <QObject>
+#include <QJsonObject>
+#include <QVector>
+#include <functional>
+#include <vector>
+
+struct GeneratedPassword
+{
+    QString password;
+    double entropy = 0;
+};
+
+using PasswordGeneratorCb = std::function<void(const QVector<GeneratedPassword> &passwords)>;
+
+/**
+ * @brief The PasswordGenerator class
+ * Generates and scores (zxcvbn entropy) batches of random passwords
+ * on the global thread pool. Each worker gets its own generator
+ * seeded from the given seed and its chunk index.
+ */
+class PasswordGenerator
+{
+public:
+    /**
+     * Build the character pool from a password profile, using the
+     * same keys as the GUI profiles: use_lowercase, use_uppercase,
+     * use_digits, use_symbols and symbols
+     */
+    static std::vector<char> poolFromProfile(const QJsonObject &profile);
+
+    /**
+     * Generate count passwords of length characters from pool,
+     * cb is called from the thread of context once all are ready
+     */
+    static void generate(const std::vector<char> &pool, int length, int count,
+                         const std::vector<qint64> &seed,
+                         QObject *context, PasswordGeneratorCb cb);
+
+    static QVector<GeneratedPassword> generateChunk(const std::vector<char> &pool, int length, int count,
+                                                    const std::vector<qint64> &seed, int chunk);
+
+    static constexpr int CHUNK_SIZE = 16;
+};
+
+#endif // PASSWORDGENERATOR_H
@@ -1,4 +1,5 @@
 #include "DeviceSettings.h"
+#include <QSettings>
 
 DeviceSettings::DeviceSettings(QObject *parent)
     : QObject(parent)
@@ -60,6 +61,59 @@ void DeviceSettings::setProperty(const QString &propName, int value)
     }
 }
 
+void DeviceSettings::loadCachedParameters(quint32 serialNumber)
+{
+    if (m_paramsLoaded || 0 == serialNumber)
+    {
+        return;
+    }
+
+    QSettings s;
+    const QVariantMap cached = s.value(CACHE_SETTING_PREFIX + QString::number(serialNumber)).toMap();
+    if (cached.isEmpty())
+    {
+        return;
+    }
+
+    qDebug() << "Using cached parameters of device" << serialNumber << "until they are read";
+    restoreCacheData(cached);
+}
+
+void DeviceSettings::saveCachedParameters(quint32 serialNumber)
+{
+    m_paramsLoaded = true;
+    if (0 == serialNumber)
+    {
+        return;
+    }
+
+    QSettings s;
+    s.setValue(CACHE_SETTING_PREFIX + QString::number(serialNumber), cacheData());
+}
+
+QVariantMap DeviceSettings::cacheData() const
+{
+    QVariantMap data;
+    auto* metaObj = metaObject();
+    while (nullptr != metaObj && QString{metaObj->className()} != "QObject")
+    {
+        for (int i = metaObj->propertyOffset(); i < metaObj->propertyCount(); ++i)
+        {
+            data[metaObj->property(i).name()] = metaObj->property(i).read(this);
+        }
+        metaObj = metaObj->superClass();
+    }
+    return data;
+}
+
+void DeviceSettings::restoreCacheData(const QVariantMap &data)
+{
+    for (auto it = data.constBegin(); it != data.constEnd(); ++it)
+    {
+        setProperty(it.key(), it.value().toInt());
+    }
+}
+
 void DeviceSettings::sendEveryParameter(const QMetaObject* meta)
 {
     for (int i = meta->propertyOffset(); i < meta->propertyCount(); ++i)
@@ -45,6 +45,11 @@ public:
     void updateParam(MPParams::Param param, bool en);
     virtual void setupKeyboardLayout(bool) {}
 
+    //parameters snapshot of the last connection, displayed until the
+    //parameters are loaded from the device
+    void loadCachedParameters(quint32 serialNumber);
+    void saveCachedParameters(quint32 serialNumber);
+
     const QMetaObject* getMetaObject() const {return metaObject();}
 
 protected:
@@ -57,10 +62,17 @@ protected:
     void convertKnockValue(int& val);
     int convertBackKnockValue(int val);
 
+    virtual QVariantMap cacheData() const;
+    virtual void restoreCacheData(const QVariantMap& data);
+
     QMap<MPParams::Param, QString> m_paramMap;
 
     //flag set when loading all parameters
     bool m_readingParams = false;
+    //flag set once parameters were read from the device
+    bool m_paramsLoaded = false;
+
+    const QString CACHE_SETTING_PREFIX = "settings/device_params_";
 };
 
 #endif // DEVICESETTINGS_H
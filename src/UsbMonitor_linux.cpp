@@ -26,7 +26,7 @@ QString UsbMonitor_linux::REMOVE_ACTION = "remove";
 
 UsbMonitor_linux::UsbMonitor_linux()
 {
-    struct udev* udev = udev_new();
+    udev = udev_new();
     mon = udev_monitor_new_from_netlink(udev, "udev");
 
     //Filter hidraw devices
@@ -42,49 +42,70 @@ UsbMonitor_linux::UsbMonitor_linux()
 UsbMonitor_linux::~UsbMonitor_linux()
 {
     delete sockMonitor;
+    udev_monitor_unref(mon);
+    udev_unref(udev);
 }
 
 void UsbMonitor_linux::monitorUSB(int fd)
 {
     Q_UNUSED(fd);
     const auto dev = udev_monitor_receive_device(mon);
-    const char *dev_path = udev_device_get_devnode(dev);
-    bool unrefed = false;
     if (dev)
     {
         QString node(udev_device_get_devnode(dev));
         QString action(udev_device_get_action(dev));
+        QString sysPath(udev_device_get_syspath(dev));
         qDebug() << "Node: " << node;
         qDebug() << "Action: " << action;
         if (ADD_ACTION == action && node.contains("hidraw"))
         {
-            /**
-              * Need to add a delay, because without
-              * it the device haven't detected yet
-              * during usb enumeration.
-              */
-            bool isBLE, isBT;
-            if (MPDevice_linux::checkDevice(dev, isBLE, isBT))
-            {
-                QTimer::singleShot(100, [this, dev_path, isBLE, isBT]()
-                {
-                    emit usbDeviceAdded(QString::fromUtf8(dev_path), isBLE, isBT);
-                });
-            }
-            unrefed = true;
+            probeAddedDevice(sysPath, 0);
         }
         else if (REMOVE_ACTION == action && node.contains("hidraw"))
         {
-            emit usbDeviceRemoved(QString::fromUtf8(dev_path));
-        }
-        //If it has not been unrefed in checkDevice
-        if (!unrefed)
-        {
-            udev_device_unref(dev);
+            MPDevice_linux::forgetDevice(sysPath);
+            emit usbDeviceRemoved(node);
         }
+        udev_device_unref(dev);
     }
     else
     {
         printf("No Device from receive_device(). An error occured.\n");
     }
 }
+
+void UsbMonitor_linux::probeAddedDevice(const QString &sysPath, int attempt)
+{
+    struct udev_device *dev = udev_device_new_from_syspath(udev, sysPath.toUtf8().constData());
+    if (!dev)
+    {
+        //Node is already gone
+        return;
+    }
+
+    const QString node = QString::fromUtf8(udev_device_get_devnode(dev));
+    bool isBLE = false, isBT = false;
+    const auto res = MPDevice_linux::probeDevice(dev, isBLE, isBT);
+    udev_device_unref(dev);
+
+    if (MPDevice_linux::ProbeResult::MOOLTIPASS == res)
+    {
+        emit usbDeviceAdded(node, isBLE, isBT);
+    }
+    else if (MPDevice_linux::ProbeResult::NOT_READY == res)
+    {
+        /**
+          * The node exists but cannot be opened yet, because
+          * usb enumeration or udev rules are not finished.
+          */
+        if (attempt + 1 >= PROBE_MAX_ATTEMPTS)
+        {
+            qWarning() << "Mooltipass device never became ready: " << node;
+            return;
+        }
+        QTimer::singleShot(PROBE_FIRST_DELAY << attempt, this, [this, sysPath, attempt]()
+        {
+            probeAddedDevice(sysPath, attempt + 1);
+        });
+    }
+}
@@ -43,9 +43,20 @@ signals:
 private:
     UsbMonitor_linux();
 
+    /**
+     * @brief probeAddedDevice
+     * Probe only the node that was added. If the node is not
+     * ready yet, retry with an exponential backoff.
+     */
+    void probeAddedDevice(const QString &sysPath, int attempt);
+
     QSocketNotifier *sockMonitor = nullptr;
+    struct udev* udev;
     struct udev_monitor* mon;
 
+    static constexpr int PROBE_FIRST_DELAY = 5;
+    static constexpr int PROBE_MAX_ATTEMPTS = 8;
+
     static QString ADD_ACTION;
     static QString REMOVE_ACTION;
 };
@@ -633,6 +633,12 @@ void WSClient::sendCredentialsMM(const QJsonArray &creds)
                   { "data", creds }});
 }
 
+void WSClient::sendCredentialsDeltaMM(const QJsonObject &delta)
+{
+    sendJsonData({{ "msg", "set_credentials" },
+                  { "data", delta }});
+}
+
 void WSClient::exportDbFile(const QString &encryption)
 {
     QJsonObject d = {{ "encryption", encryption }};
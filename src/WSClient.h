@@ -89,6 +89,7 @@ public:
     void serviceExists(bool isDatanode, const QString &service);
 
     void sendCredentialsMM(const QJsonArray &creds);
+    void sendCredentialsDeltaMM(const QJsonObject &delta);
 
     void exportDbFile(const QString &encryption);
     void importDbFile(const QByteArray &fileData, bool noDelete);
@@ -22,8 +22,13 @@
 #include "ParseDomain.h"
 #include "MPDeviceBleImpl.h"
 #include "HaveIBeenPwned.h"
+#include "DeviceMetrics.h"
 
 #include <QCryptographicHash>
+#include <QtConcurrent/QtConcurrent>
+#include <QFutureWatcher>
+#include <QtEndian>
+#include <memory>
 
 WSServerCon::WSServerCon(QWebSocket *conn):
     wsClient(conn),
@@ -88,6 +93,17 @@ void WSServerCon::processMessage(const QString &message)
         sendJsonMessage(oroot);
         return;
     }
+    else if (root["msg"] == "get_metrics")
+    {
+        QJsonObject oroot = root;
+        oroot["data"] = DeviceMetrics::Instance()->toJson();
+        sendJsonMessage(oroot);
+        if (root["data"].toObject()["reset"].toBool())
+        {
+            DeviceMetrics::Instance()->reset();
+        }
+        return;
+    }
     else if (root["msg"] == "show_status_notification_warning")
     {
         QJsonDocument showWarningDoc(root);
@@ -172,6 +188,14 @@ void WSServerCon::processMessage(const QString &message)
             sendJsonMessage(oroot);
         });
     }
+    else if (root["msg"] == "generate_passwords")
+    {
+        processGeneratePasswords(root);
+    }
+    else if (root["msg"] == "audit_passwords")
+    {
+        processPasswordAudit(root);
+    }
     else if (root["msg"] == "start_memorymgmt")
     {
         QJsonObject o = root["data"].toObject();
@@ -207,11 +231,7 @@ void WSServerCon::processMessage(const QString &message)
             return;
         }
 
-        mpdevice->setMMCredentials(
-                    root["data"].toArray(),
-                    false,
-                    defaultProgressCb,
-                    [=](bool success, QString errstr)
+        auto cb = [=](bool success, QString errstr)
         {
             if (!WSServer::Instance()->checkClientExists(this))
                 return;
@@ -227,7 +247,26 @@ void WSServerCon::processMessage(const QString &message)
             ores["success"] = "true";
             oroot["data"] = ores;
             sendJsonMessage(oroot);
-        });
+        };
+
+        if (root["data"].isObject())
+        {
+            //Delta mode: only the modified/added credentials and the addresses of the deleted ones
+            QJsonObject o = root["data"].toObject();
+            mpdevice->setMMCredentialsDelta(
+                        o["credentials"].toArray(),
+                        o["deleted"].toArray(),
+                        defaultProgressCb,
+                        cb);
+        }
+        else
+        {
+            mpdevice->setMMCredentials(
+                        root["data"].toArray(),
+                        false,
+                        defaultProgressCb,
+                        cb);
+        }
     }
     else if (root["msg"] == "cancel_request")
     {
@@ -610,6 +649,17 @@ void WSServerCon::sendInitialStatus()
         if (mpdevice->isBLE())
         {
             sendIsConnectedWithBluetooth();
+            if (auto bleImpl = mpdevice->ble())
+            {
+                if (!bleImpl->getDeviceLanguages().isEmpty())
+                {
+                    sendDeviceLanguage(bleImpl->getDeviceLanguages());
+                }
+                if (!bleImpl->getKeyboardLayouts().isEmpty())
+                {
+                    sendKeyboardLayout(bleImpl->getKeyboardLayouts());
+                }
+            }
         }
     }
 }
@@ -621,24 +671,26 @@ void WSServerCon::sendMemMgmtMode()
     sendJsonMessage({{ "msg", "memorymgmt_changed" },
                      { "data", mpdevice->get_memMgmtMode() }});
 
-    QJsonArray logins;
-    foreach (MPNode *n, mpdevice->getLoginNodes())
-    {
-        logins.append(n->toJson());
-    }
-
-    QJsonArray datas;
-    foreach (MPNode *n, mpdevice->getDataNodes())
-    {
-        datas.append(n->toJson());
-    }
-
-    QJsonObject jdata;
-    jdata["login_nodes"] = logins;
-    jdata["data_nodes"] = datas;
-
-    sendJsonMessage({{ "msg", "memorymgmt_data" },
-                     { "data", jdata }});
+    //The node tree can be several MB of JSON, it is built and encoded
+    //from a snapshot on the device serialization pool. Only the latest
+    //request is sent if the mode changes again meanwhile.
+    const quint32 seq = ++memMgmtDataSeq;
+    auto snapshot = mpdevice->snapshotMemMgmtNodes();
+    auto future = QtConcurrent::run(mpdevice->serializationPool(), [snapshot]()
+    {
+        const QJsonObject oroot = {{ "msg", "memorymgmt_data" },
+                                   { "data", snapshot->toJson() }};
+        return QString::fromUtf8(QJsonDocument(oroot).toJson(QJsonDocument::JsonFormat::Compact));
+    });
+
+    auto *watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, seq]()
+    {
+        watcher->deleteLater();
+        if (seq == memMgmtDataSeq)
+            sendJsonMessageString(watcher->result());
+    });
+    watcher->setFuture(future);
 }
 
 void WSServerCon::sendVersion()
@@ -1086,7 +1138,9 @@ void WSServerCon::processMessageBLE(QJsonObject root, const MPDeviceProgressCb &
         auto type = static_cast<Common::FetchType>(o["type"].toInt());
         const auto cmd = Common::FetchType::ACCELEROMETER == type ?
                     MPCmd::CMD_DBG_GET_ACC_32_SAMPLES : MPCmd::GET_RANDOM_NUMBER;
-        bleImpl->fetchData(o["file"].toString(), cmd);
+        bleImpl->fetchData(o["file"].toString(), cmd,
+                           FetchDataWriter::formatFromString(o["format"].toString()),
+                           cbProgress);
     }
     else if (root["msg"] == "stop_fetch_data")
     {
@@ -1285,6 +1339,205 @@ bool WSServerCon::checkMemModeEnabled(const QJsonObject &root)
     return false;
 }
 
+void WSServerCon::processGeneratePasswords(const QJsonObject &root)
+{
+    const QJsonObject o = root["data"].toObject();
+    const std::vector<char> pool = PasswordGenerator::poolFromProfile(o["profile"].toObject());
+    const int length = o["length"].toInt(Common::DEFAULT_PASSWORD_LENGTH);
+    const QJsonArray credentials = o["credentials"].toArray();
+    const int count = credentials.isEmpty() ? o["count"].toInt(1) : credentials.size();
+
+    if (pool.empty())
+    {
+        sendFailedJson(root, "Password profile does not contain any character");
+        return;
+    }
+    if (length < 1 || length > MAX_GENERATED_PASSWORD_LENGTH ||
+        count < 1 || count > MAX_GENERATED_PASSWORDS)
+    {
+        sendFailedJson(root, "Invalid password length or count");
+        return;
+    }
+
+    mpdevice->getRandomNumber([=](bool success, QString errstr, const QByteArray &rndNums)
+    {
+        if (!WSServer::Instance()->checkClientExists(this))
+            return;
+
+        if (!success)
+        {
+            sendFailedJson(root, errstr);
+            return;
+        }
+
+        //Mix the device entropy with the host seed
+        std::vector<qint64> seed = Common::getRngSeed();
+        for (int i = 0; i + 8 <= rndNums.size(); i += 8)
+        {
+            seed.push_back(qFromLittleEndian<qint64>(reinterpret_cast<const uchar *>(rndNums.constData() + i)));
+        }
+
+        PasswordGenerator::generate(pool, length, count, seed, this,
+                                    [=](const QVector<GeneratedPassword> &passwords)
+        {
+            //The client is deleted with its connection, nothing can be answered
+            if (!WSServer::Instance()->checkClientExists(this))
+                return;
+
+            if (!credentials.isEmpty())
+            {
+                //The device may have been unplugged during the generation
+                if (!mpdevice)
+                {
+                    sendFailedJson(root, "No device connected");
+                    return;
+                }
+                storeGeneratedPasswords(root, credentials, passwords);
+                return;
+            }
+
+            QJsonArray arr;
+            for (const auto &p : passwords)
+            {
+                arr.append(QJsonObject{{ "password", p.password }, { "entropy", p.entropy }});
+            }
+            QJsonObject oroot = root;
+            oroot["data"] = QJsonObject{{ "passwords", arr }};
+            sendJsonMessage(oroot);
+        });
+    });
+}
+
+void WSServerCon::storeGeneratedPasswords(const QJsonObject &root, const QJsonArray &credentials,
+                                          const QVector<GeneratedPassword> &passwords)
+{
+    //Every credential is queued as its own job on the device,
+    //the answer is sent once all of them are done
+    const int total = qMin(credentials.size(), passwords.size());
+    auto results = std::make_shared<QJsonArray>();
+    auto pending = std::make_shared<int>(total);
+    for (int i = 0; i < total; ++i)
+    {
+        results->append(QJsonValue());
+    }
+
+    for (int i = 0; i < total; ++i)
+    {
+        const QJsonObject c = credentials[i].toObject();
+        const QString service = c["service"].toString();
+        const QString login = c["login"].toString();
+
+        auto cb = [=](bool success, QString errstr)
+        {
+            if (!WSServer::Instance()->checkClientExists(this))
+                return;
+
+            QJsonObject res = {{ "service", service }, { "login", login },
+                               { "entropy", passwords[i].entropy }, { "success", success }};
+            if (!success)
+            {
+                res["error_message"] = errstr;
+            }
+            results->replace(i, res);
+
+            if (--(*pending) == 0)
+            {
+                QJsonObject oroot = root;
+                oroot["data"] = QJsonObject{{ "credentials", *results }};
+                sendJsonMessage(oroot);
+            }
+        };
+
+        if (mpdevice->isBLE())
+        {
+            mpdevice->ble()->checkAndStoreCredential(BleCredential{service, login, c["description"].toString(),
+                                                                   "", passwords[i].password}, cb);
+        }
+        else
+        {
+            mpdevice->setCredential(service, login, passwords[i].password,
+                                    c["description"].toString(), c.contains("description"), cb);
+        }
+    }
+}
+
+void WSServerCon::processPasswordAudit(const QJsonObject &root)
+{
+    //The client sends the credential list (and dates) it got from
+    //the memory management dump, passwords are then fetched one by
+    //one with the regular get credential path
+    const QJsonObject o = root["data"].toObject();
+    const QJsonArray credentials = o["credentials"].toArray();
+    if (credentials.isEmpty() || credentials.size() > MAX_AUDITED_CREDENTIALS)
+    {
+        sendFailedJson(root, "Invalid credential list");
+        return;
+    }
+
+    auto *audit = new PasswordAudit(credentials.size(), o["stale_days"].toInt(DEFAULT_STALE_DAYS), this);
+    connect(audit, &PasswordAudit::resultReady, this, [this, root](const QJsonObject &result)
+    {
+        QJsonObject oroot = root;
+        oroot["msg"] = "audit_passwords_result";
+        oroot["data"] = result;
+        sendJsonMessage(oroot);
+    });
+    connect(audit, &PasswordAudit::finished, this, [this, root, audit](const QJsonObject &summary)
+    {
+        QJsonObject oroot = root;
+        oroot["data"] = summary;
+        sendJsonMessage(oroot);
+        audit->deleteLater();
+    });
+
+    //audit is owned by this connection, it is gone if the client is
+    QPointer<PasswordAudit> auditPtr = audit;
+    for (int i = 0; i < credentials.size(); ++i)
+    {
+        const QJsonObject c = credentials[i].toObject();
+        PasswordAudit::Credential cred;
+        cred.index = i;
+        cred.service = c["service"].toString();
+        cred.login = c["login"].toString();
+        cred.dateCreated = QDate::fromString(c["date_created"].toString(), Qt::ISODate);
+        cred.dateLastUsed = QDate::fromString(c["date_last_used"].toString(), Qt::ISODate);
+
+        if (mpdevice->isBLE())
+        {
+            auto bleImpl = mpdevice->ble();
+            bleImpl->getCredential(cred.service, cred.login, QString(), QString(),
+                    [auditPtr, bleImpl, cred](bool success, QString errstr, QByteArray data)
+            {
+                if (!auditPtr)
+                    return;
+
+                if (!success)
+                {
+                    auditPtr->addFailure(cred, errstr);
+                    return;
+                }
+
+                auto bleCred = bleImpl->retrieveCredentialFromResponse(data, cred.service, cred.login);
+                auditPtr->addPassword(cred, bleCred.get(BleCredential::CredAttr::PASSWORD));
+            });
+        }
+        else
+        {
+            mpdevice->getCredential(cred.service, cred.login, QString(), QString(),
+                    [auditPtr, cred](bool success, QString errstr, const QString &, const QString &, const QString &pass, const QString &)
+            {
+                if (!auditPtr)
+                    return;
+
+                if (!success)
+                    auditPtr->addFailure(cred, errstr);
+                else
+                    auditPtr->addPassword(cred, pass);
+            });
+        }
+    }
+}
+
 bool WSServerCon::processSetCredential(QJsonObject &root, QJsonObject &o)
 {
     QString loginName = o["login"].toString();
@@ -23,6 +23,8 @@
 #include <QWebSocket>
 #include "Common.h"
 #include "MPManager.h"
+#include "PasswordGenerator.h"
+#include "PasswordAudit.h"
 
 class WSServer;
 class HaveIBeenPwned;
@@ -80,6 +82,9 @@ private:
 
     QString clientUid;
 
+    //Incremented for each memorymgmt_data serialization, older ones are dropped
+    quint32 memMgmtDataSeq = 0;
+
     HaveIBeenPwned *hibp = nullptr;
 
     void processParametersSet(const QJsonObject &data);
@@ -88,6 +93,15 @@ private:
     void checkHaveIBeenPwned(const QString &service, const QString &login, const QString &password);
     void processMessageMini(QJsonObject root, const MPDeviceProgressCb &cbProgress);
     void processMessageBLE(QJsonObject root, const MPDeviceProgressCb &cbProgress);
+    void processGeneratePasswords(const QJsonObject &root);
+    void storeGeneratedPasswords(const QJsonObject &root, const QJsonArray &credentials,
+                                 const QVector<GeneratedPassword> &passwords);
+    void processPasswordAudit(const QJsonObject &root);
+
+    static constexpr int MAX_GENERATED_PASSWORDS = 1000;
+    static constexpr int MAX_GENERATED_PASSWORD_LENGTH = MP_MAX_PASSWORD_LENGTH - 1;
+    static constexpr int MAX_AUDITED_CREDENTIALS = 2000;
+    static constexpr int DEFAULT_STALE_DAYS = 365;
 };
 
 #endif // WSSERVERCON_H
@@ -1108,6 +1108,11 @@ static int OutputBinary(ostream *Out, const string & ChkFile, const string & Cha
     h(CharSet.c_str(), CharSet.length());
     OutputSize += CharSet.length();
 
+    // Checksum of everything above, checked when the file is loaded
+    TrieCheck::Check_t Crc = h.Result();
+    Out->write((char *)&Crc, sizeof Crc);
+    OutputSize += sizeof Crc;
+
     if (!ChkFile.empty())
     {
         // Write the checksum file
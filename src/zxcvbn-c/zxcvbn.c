@@ -38,10 +38,13 @@
 #include <float.h>
 
 #ifdef USE_DICT_FILE
-#if defined(USE_FILE_IO) || !defined(__cplusplus)
-#include <stdio.h>
+#ifdef _WIN32
+#include <windows.h>
 #else
-#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 #endif
 
@@ -250,42 +253,23 @@ static void AddMatchRepeats(ZxcMatch_t **Result, ZxcMatch_t *Match, const uint8_
  *################################################################################*/
 
 #ifdef USE_DICT_FILE
-/* Use dictionary data from file */
-
-#if defined(USE_FILE_IO) || !defined(__cplusplus)
-/* Use the FILE streams from stdio.h */
-
-typedef FILE *FileHandle;
-
-#define MyOpenFile(f, name)       (f = fopen(name, "rb"))
-#define MyReadFile(f, buf, bytes) (fread(buf, 1, bytes, f) == (bytes))
-#define MyCloseFile(f)            fclose(f)
-
-#else
-
-/* Use the C++ iostreams */
-typedef std::ifstream FileHandle;
-
-static inline void MyOpenFile(FileHandle & f, const char *Name)
-{
-    f.open(Name, std::ifstream::in | std::ifstream::binary);
-}
-static inline bool MyReadFile(FileHandle & f, void *Buf, unsigned int Num)
-{
-    return (bool)f.read((char *)Buf, Num);
-}
-static inline void MyCloseFile(FileHandle & f)
-{
-    f.close();
-}
-
-#endif
-
-/* Include file contains the CRC of the dictionary data file. Used to detect corruption */
-/* of the file. */
-#include "dict-crc.h"
-
-#define MAX_DICT_FILE_SIZE  (100+WORD_FILE_SIZE)
+/* Use dictionary data from file. The file is memory mapped read only, so the */
+/* pages are shared between processes using the same dictionary and are only  */
+/* loaded when the trie is walked. */
+
+/* Layout of the trie, must match the values used by dict-generate */
+#define ROOT_NODE_LOC 0
+#define BITS_CHILD_PATT_INDEX 14
+#define BITS_CHILD_MAP_INDEX  18
+#define SHIFT_CHILD_MAP_INDEX BITS_CHILD_PATT_INDEX
+#define SHIFT_WORD_ENDING_BIT (SHIFT_CHILD_MAP_INDEX + BITS_CHILD_MAP_INDEX)
+
+/* The file is: 10 header words, the dictionary data and the CRC-64 of both. */
+/* The CRC is stored in the file so a dictionary can be replaced without */
+/* rebuilding the program. */
+#define DICT_HEADER_SIZE    (10 * sizeof(unsigned int))
+#define DICT_CRC_SIZE       sizeof(uint64_t)
+#define MAX_DICT_FILE_SIZE  (64 * 1024 * 1024)
 #define CHK_INIT 0xffffffffffffffffULL
 
 /* Static table used for the crc implementation. */
@@ -302,14 +286,23 @@ static const unsigned int MAGIC = 'z' + ('x'<< 8) + ('c' << 16) + ('v' << 24);
 static unsigned int NumNodes, NumChildLocs, NumRanks, NumWordEnd, NumChildMaps;
 static unsigned int SizeChildMapEntry, NumLargeCounts, NumSmallCounts, SizeCharSet;
 
-static unsigned int   *DictNodes;
-static uint8_t        *WordEndBits;
-static unsigned int   *ChildLocs;
-static unsigned short *Ranks;
-static uint8_t        *ChildMap;
-static uint8_t        *EndCountLge;
-static uint8_t        *EndCountSml;
-static char           *CharSet;
+static const unsigned int   *DictNodes;
+static const uint8_t        *WordEndBits;
+static const unsigned int   *ChildLocs;
+static const unsigned short *Ranks;
+static const uint8_t        *ChildMap;
+static const uint8_t        *EndCountLge;
+static const uint8_t        *EndCountSml;
+static const char           *CharSet;
+
+/* The character set is not nul terminated in the file */
+static char CharSetBuf[256];
+
+static const uint8_t *DictMap;
+static size_t DictMapSize;
+#ifdef _WIN32
+static HANDLE DictMapHandle;
+#endif
 
 /**********************************************************************************
  * Calculate the CRC-64 of passed data.
@@ -319,7 +312,7 @@ static char           *CharSet;
  *  Len     Length of the passed data
  * Returns the updated CRC value.
  */
-static uint64_t CalcCrc64(uint64_t Crc, const void *v, unsigned int Len)
+static uint64_t CalcCrc64(uint64_t Crc, const void *v, size_t Len)
 {
     const uint8_t *Data = (const unsigned char *)v;
     while(Len--)
@@ -332,122 +325,162 @@ static uint64_t CalcCrc64(uint64_t Crc, const void *v, unsigned int Len)
 }
 
 /**********************************************************************************
- * Read the dictionary data from file.
+ * Map the whole dictionary file read only in memory.
+ * Returns 1 on success, 0 on error
+ */
+static int MapDictFile(const char *Filename)
+{
+#ifdef _WIN32
+    HANDLE f;
+    LARGE_INTEGER Size;
+    f = CreateFileA(Filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f == INVALID_HANDLE_VALUE)
+        return 0;
+    if (!GetFileSizeEx(f, &Size) || Size.QuadPart <= 0 || Size.QuadPart > MAX_DICT_FILE_SIZE)
+    {
+        CloseHandle(f);
+        return 0;
+    }
+    DictMapHandle = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(f);
+    if (!DictMapHandle)
+        return 0;
+    DictMap = (const uint8_t *)MapViewOfFile(DictMapHandle, FILE_MAP_READ, 0, 0, 0);
+    if (!DictMap)
+    {
+        CloseHandle(DictMapHandle);
+        DictMapHandle = NULL;
+        return 0;
+    }
+    DictMapSize = (size_t)Size.QuadPart;
+    return 1;
+#else
+    int f;
+    struct stat St;
+    void *p;
+    f = open(Filename, O_RDONLY);
+    if (f < 0)
+        return 0;
+    if (fstat(f, &St) || St.st_size <= 0 || St.st_size > MAX_DICT_FILE_SIZE)
+    {
+        close(f);
+        return 0;
+    }
+    p = mmap(NULL, (size_t)St.st_size, PROT_READ, MAP_SHARED, f, 0);
+    close(f);
+    if (p == MAP_FAILED)
+        return 0;
+    DictMap = (const uint8_t *)p;
+    DictMapSize = (size_t)St.st_size;
+    return 1;
+#endif
+}
+
+/**********************************************************************************
+ * Release the mapping done by MapDictFile().
+ */
+static void UnmapDictFile()
+{
+    if (!DictMap)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(DictMap);
+    CloseHandle(DictMapHandle);
+    DictMapHandle = NULL;
+#else
+    munmap((void *)DictMap, DictMapSize);
+#endif
+    DictMap = 0;
+    DictMapSize = 0;
+    DictNodes = 0;
+}
+
+/**********************************************************************************
+ * Map the dictionary data from file.
  * Parameters:
  *  Filename    Name of the file to read.
  * Returns 1 on success, 0 on error
  */
 int ZxcvbnInit(const char *Filename)
 {
-    FileHandle f;
-    uint64_t Crc = CHK_INIT;
+    const unsigned int *Hdr;
+    size_t DictSize;
+    uint64_t Crc;
     if (DictNodes)
         return 1;
-    MyOpenFile(f, Filename);
-    if (f)
+    if (!MapDictFile(Filename))
+        return 0;
+    if (DictMapSize < DICT_HEADER_SIZE + DICT_CRC_SIZE)
     {
-        unsigned int i, DictSize;
-
-        /* Get magic number */
-        if (!MyReadFile(f, &i, sizeof i))
-            i = 0;
+        UnmapDictFile();
+        return 0;
+    }
 
-        /* Get header data */
-        if (!MyReadFile(f, &NumNodes, sizeof NumNodes))
-            i = 0;
-        if (!MyReadFile(f, &NumChildLocs, sizeof NumChildLocs))
-            i = 0;
-        if (!MyReadFile(f, &NumRanks, sizeof NumRanks))
-            i = 0;
-        if (!MyReadFile(f, &NumWordEnd, sizeof NumWordEnd))
-            i = 0;
-        if (!MyReadFile(f, &NumChildMaps, sizeof NumChildMaps))
-            i = 0;
-        if (!MyReadFile(f, &SizeChildMapEntry, sizeof SizeChildMapEntry))
-            i = 0;
-        if (!MyReadFile(f, &NumLargeCounts, sizeof NumLargeCounts))
-            i = 0;
-        if (!MyReadFile(f, &NumSmallCounts, sizeof NumSmallCounts))
-            i = 0;
-        if (!MyReadFile(f, &SizeCharSet, sizeof SizeCharSet))
-            i = 0;
+    /* Get header data */
+    Hdr = (const unsigned int *)DictMap;
+    NumNodes = Hdr[1];
+    NumChildLocs = Hdr[2];
+    NumRanks = Hdr[3];
+    NumWordEnd = Hdr[4];
+    NumChildMaps = Hdr[5];
+    SizeChildMapEntry = Hdr[6];
+    NumLargeCounts = Hdr[7];
+    NumSmallCounts = Hdr[8];
+    SizeCharSet = Hdr[9];
+
+    /* Validate the header data */
+    if ((Hdr[0] != MAGIC) ||
+        (NumNodes >= (1<<17)) ||
+        (NumChildLocs >= (1<<BITS_CHILD_MAP_INDEX)) ||
+        (NumChildMaps >= (1<<BITS_CHILD_PATT_INDEX)) ||
+        ((SizeChildMapEntry*8) < SizeCharSet) || (SizeChildMapEntry > 32) ||
+        (NumLargeCounts >= (1<<9)) ||
+        (NumSmallCounts != NumNodes) ||
+        (NumRanks >= MAX_DICT_FILE_SIZE) ||
+        (NumWordEnd >= MAX_DICT_FILE_SIZE) ||
+        (SizeCharSet >= sizeof CharSetBuf))
+    {
+        UnmapDictFile();
+        return 0;
+    }
 
-        /* Validate the header data */
-        if (NumNodes >= (1<<17))
-            i = 1;
-        if (NumChildLocs >= (1<<BITS_CHILD_MAP_INDEX))
-            i = 2;
-        if (NumChildMaps >= (1<<BITS_CHILD_PATT_INDEX))
-            i = 3;
-        if ((SizeChildMapEntry*8) < SizeCharSet)
-            i = 4;
-        if (NumLargeCounts >= (1<<9))
-            i = 5;
-        if (NumSmallCounts != NumNodes)
-            i = 6;
-
-        if (i != MAGIC)
-        {
-            MyCloseFile(f);
-            return 0;
-        }
-        Crc = CalcCrc64(Crc, &i,    sizeof i);
-        Crc = CalcCrc64(Crc, &NumNodes,     sizeof NumNodes);
-        Crc = CalcCrc64(Crc, &NumChildLocs, sizeof NumChildLocs);
-        Crc = CalcCrc64(Crc, &NumRanks,     sizeof NumRanks);
-        Crc = CalcCrc64(Crc, &NumWordEnd,   sizeof NumWordEnd);
-        Crc = CalcCrc64(Crc, &NumChildMaps, sizeof NumChildMaps);
-        Crc = CalcCrc64(Crc, &SizeChildMapEntry, sizeof SizeChildMapEntry);
-        Crc = CalcCrc64(Crc, &NumLargeCounts,   sizeof NumLargeCounts);
-        Crc = CalcCrc64(Crc, &NumSmallCounts,   sizeof NumSmallCounts);
-        Crc = CalcCrc64(Crc, &SizeCharSet,      sizeof SizeCharSet);
-
-        DictSize = NumNodes*sizeof(*DictNodes) + NumChildLocs*sizeof(*ChildLocs) + NumRanks*sizeof(*Ranks) +
-                   NumWordEnd + NumChildMaps*SizeChildMapEntry + NumLargeCounts + NumSmallCounts + SizeCharSet;
-        if (DictSize < MAX_DICT_FILE_SIZE)
-        {
-            DictNodes = MallocFn(unsigned int, DictSize / sizeof(unsigned int) + 1);
-            if (!MyReadFile(f, DictNodes, DictSize))
-            {
-                FreeFn(DictNodes);
-                DictNodes = 0;
-            }
-        }
-        MyCloseFile(f);
+    DictSize = (size_t)NumNodes*sizeof(*DictNodes) + (size_t)NumChildLocs*sizeof(*ChildLocs) +
+               (size_t)NumRanks*sizeof(*Ranks) + NumWordEnd + (size_t)NumChildMaps*SizeChildMapEntry +
+               NumLargeCounts + NumSmallCounts + SizeCharSet;
+    if (DictMapSize != DICT_HEADER_SIZE + DictSize + DICT_CRC_SIZE)
+    {
+        UnmapDictFile();
+        return 0;
+    }
 
-        if (!DictNodes)
-            return 0;
-        /* Check crc */
-        Crc = CalcCrc64(Crc, DictNodes, DictSize);
-        if (memcmp(&Crc, WordCheck, sizeof Crc))
-        {
-            /* File corrupted */
-            FreeFn(DictNodes);
-            DictNodes = 0;
-            return 0;
-        }
-        fflush(stdout);
-        /* Set pointers to the data */
-        ChildLocs = DictNodes + NumNodes;
-        Ranks = (unsigned short *)(ChildLocs + NumChildLocs);
-        WordEndBits = (unsigned char *)(Ranks + NumRanks);
-        ChildMap = (unsigned char*)(WordEndBits + NumWordEnd);
-        EndCountLge = ChildMap + NumChildMaps*SizeChildMapEntry;
-        EndCountSml = EndCountLge + NumLargeCounts;
-        CharSet = (char *)EndCountSml + NumSmallCounts;
-        CharSet[SizeCharSet] = 0;
-        return 1;
+    /* Check crc */
+    Crc = CalcCrc64(CHK_INIT, DictMap, DICT_HEADER_SIZE + DictSize);
+    if (memcmp(&Crc, DictMap + DICT_HEADER_SIZE + DictSize, sizeof Crc))
+    {
+        /* File corrupted */
+        UnmapDictFile();
+        return 0;
     }
-    return 0;
+
+    /* Set pointers to the data */
+    DictNodes = (const unsigned int *)(DictMap + DICT_HEADER_SIZE);
+    ChildLocs = DictNodes + NumNodes;
+    Ranks = (const unsigned short *)(ChildLocs + NumChildLocs);
+    WordEndBits = (const unsigned char *)(Ranks + NumRanks);
+    ChildMap = WordEndBits + NumWordEnd;
+    EndCountLge = ChildMap + NumChildMaps*SizeChildMapEntry;
+    EndCountSml = EndCountLge + NumLargeCounts;
+    memcpy(CharSetBuf, EndCountSml + NumSmallCounts, SizeCharSet);
+    CharSetBuf[SizeCharSet] = 0;
+    CharSet = CharSetBuf;
+    return 1;
 }
 /**********************************************************************************
- * Free the data allocated by ZxcvbnInit().
+ * Release the dictionary data mapped by ZxcvbnInit().
  */
 void ZxcvbnUnInit()
 {
-    if (DictNodes)
-        FreeFn(DictNodes);
-    DictNodes = 0;
+    UnmapDictFile();
 }
 
 #else
@@ -902,6 +935,11 @@ static void DictionaryMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Star
     DictWork_t Wrk;
     DictMatchInfo_t Extra;
 
+#ifdef USE_DICT_FILE
+    /* No dictionary loaded, only the other matchers are used */
+    if (!DictNodes)
+        return;
+#endif
     memset(&Extra, 0, sizeof Extra);
     memset(&Wrk, 0, sizeof Wrk);
     Wrk.Ordinal = 1;
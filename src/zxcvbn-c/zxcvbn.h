@@ -32,16 +32,11 @@
  * 
  **********************************************************************************/
 
-/* If this is defined, the dictiononary data is read from file. When undefined */
-/* dictionary data is included in the source code. */
+/* If this is defined, the dictiononary data is memory mapped from the file */
+/* generated by "dictgen -b". When undefined dictionary data is included in */
+/* the source code. */
 /*#define USE_DICT_FILE */
 
-/* If this is defined, C++ builds which read dictionary data from file will use */
-/* stdio FILE streams (and fopen,fread,fclose). When undefined, C++ builds will */
-/* use std::ifstream to read dictionary data. Ignored for C builds (stdio FILE  */
-/* streams are always used). */
-/*#define USE_FILE_IO */
-
 #ifndef __cplusplus
 /* C build. Use the standard malloc/free for heap memory */
 #include <stdlib.h>
@@ -93,8 +88,8 @@ extern "C" {
 #ifdef USE_DICT_FILE
 
 /**********************************************************************************
- * Read the dictionnary data from the given file. Returns 1 if OK, 0 if error.
- * Called once at program startup.
+ * Map the dictionnary data from the given file. Returns 1 if OK, 0 if error.
+ * Called once at program startup, before any call to ZxcvbnMatch().
  */
 int ZxcvbnInit(const char *);
 
@@ -0,0 +1,53 @@
+# zxcvbn password strength estimation.
+#
+# By default the dictionary (dict-src.h) is compiled in. Build with
+# "qmake CONFIG+=zxcvbn_dict_file" to generate a packed zxcvbn.dict file
+# instead, it is memory mapped at startup (see Common::initPasswordDictionary).
+
+INCLUDEPATH += $$PWD
+
+SOURCES += $$PWD/zxcvbn.c
+HEADERS += $$PWD/zxcvbn.h
+
+isEmpty(ZXCVBN_WORDS) {
+    ZXCVBN_WORDS = \
+        $$PWD/words-eng_wiki.txt \
+        $$PWD/words-female.txt \
+        $$PWD/words-male.txt \
+        $$PWD/words-passwd.txt \
+        $$PWD/words-surname.txt \
+        $$PWD/words-tv_film.txt
+}
+
+zxcvbn_dict_file {
+    DEFINES += USE_DICT_FILE
+
+    # dictgen runs on the build host. gui and daemon build in the same
+    # directory, each one writes its own file and moves it in place.
+    DICTGEN = $$shell_path($$OUT_PWD/dictgen_$${TARGET})
+    zxcvbn_dict.target = zxcvbn.dict
+    zxcvbn_dict.depends = $$PWD/dict-generate.cpp $$ZXCVBN_WORDS
+    zxcvbn_dict.commands = \
+        $$QMAKE_CXX -std=c++11 -O2 -o $$DICTGEN $$shell_path($$PWD/dict-generate.cpp) && \
+        $$DICTGEN -b -o zxcvbn.dict.$${TARGET} $$shell_path($$ZXCVBN_WORDS) && \
+        $(MOVE) zxcvbn.dict.$${TARGET} zxcvbn.dict
+    QMAKE_EXTRA_TARGETS += zxcvbn_dict
+    PRE_TARGETDEPS += zxcvbn.dict
+    QMAKE_CLEAN += zxcvbn.dict $$DICTGEN
+
+    mac {
+        zxcvbn_dict_bundle.files = $$OUT_PWD/zxcvbn.dict
+        zxcvbn_dict_bundle.path = Contents/Resources
+        QMAKE_BUNDLE_DATA += zxcvbn_dict_bundle
+    } else:unix {
+        isEmpty(PREFIX) {
+            PREFIX = /usr/local
+        }
+        zxcvbn_dict_install.path = $$PREFIX/share/moolticute
+        zxcvbn_dict_install.files = $$OUT_PWD/zxcvbn.dict
+        zxcvbn_dict_install.CONFIG += no_check_exist
+        INSTALLS += zxcvbn_dict_install
+    }
+} else {
+    HEADERS += $$PWD/dict-src.h
+}
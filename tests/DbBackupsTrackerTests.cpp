@@ -333,3 +333,63 @@ void DbBackupsTrackerTests::getFileFormatSimpleCrypt()
     QCOMPARE(QString("SimpleCrypt"), t->getTrackedBackupFileFormat());
     t->deleteLater();
 }
+
+void DbBackupsTrackerTests::changeNumbersRefreshedOnFileChange()
+{
+    DbBackupsTracker* t = new DbBackupsTracker("/tmp/test_db_backups_tracker.info");
+    t->setCardId("00000");
+    t->setCredentialsDbChangeNumber(5);
+    t->setDataDbChangeNumber(0);
+
+    QTemporaryFile file;
+    file.open();
+    file.write("[\n    [],\n    \"moolticute\",\n    1,\n    5,\n    0,\n    3459\n]\n");
+    file.flush();
+
+    t->track(file.fileName());
+    Q_ASSERT(!t->isUpdateRequired());
+
+    // Same file, new content and size
+    file.resize(0);
+    file.write("[\n    [],\n    \"moolticute\",\n    1,\n    12,\n    0,\n    3459\n]\n");
+    file.flush();
+
+    Q_ASSERT(t->isUpdateRequired());
+    QCOMPARE(QString("none"), t->getTrackedBackupFileFormat());
+
+    // Same size rewrite, reported by the file watcher
+    t->setCredentialsDbChangeNumber(12);
+    QSignalSpy spy(t, &DbBackupsTracker::lowerDbBackupChangeNumber);
+    file.resize(0);
+    file.write("[\n    [],\n    \"moolticute\",\n    1,\n    10,\n    0,\n    3459\n]\n");
+    file.flush();
+
+    QTRY_VERIFY(spy.count() > 0);
+    Q_ASSERT(t->isBackupRequired());
+
+    t->deleteLater();
+    file.close();
+}
+
+void DbBackupsTrackerTests::changeNumbersFromUnusualLayout()
+{
+    // Keys are not in the order written by moolticute, the whole file is parsed
+    DbBackupsTracker* t = new DbBackupsTracker("/tmp/test_db_backups_tracker.info");
+    t->setCardId("00000");
+    t->setCredentialsDbChangeNumber(3);
+    t->setDataDbChangeNumber(0);
+
+    QTemporaryFile file;
+    file.open();
+    file.write("{\"payload\": \"");
+    file.write(QByteArray(8192, 'A'));
+    file.write("\", \"encryption\": \"SimpleCrypt\", \"credentialsDbChangeNumber\": 7, \"dataDbChangeNumber\": 0}");
+    file.flush();
+
+    t->track(file.fileName());
+    Q_ASSERT(t->isUpdateRequired());
+    QCOMPARE(QString("SimpleCrypt"), t->getTrackedBackupFileFormat());
+
+    t->deleteLater();
+    file.close();
+}
@@ -32,6 +32,9 @@ private slots:
     void getFileFormatLegacy();
     void getFileFormatSimpleCrypt();
 
+    void changeNumbersRefreshedOnFileChange();
+    void changeNumbersFromUnusualLayout();
+
 private:
     DbBackupsTracker tracker;
     QString getTestsDataDirPath();
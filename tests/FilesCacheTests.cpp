@@ -32,3 +32,73 @@ void FilesCacheTests::testSaveAndLoadFileNames()
 
     QVERIFY(cache.erase());
 }
+
+void FilesCacheTests::testJournalReplay()
+{
+    const QByteArray cpz = "0a1b2c3d4e5f6071";
+
+    FilesCache cache;
+    cache.setDbChangeNumber(7);
+    cache.setCardCPZ(cpz);
+    QVERIFY(cache.save(QList<QVariantMap>()));
+
+    auto makeFile = [](int i)
+    {
+        QVariantMap item;
+        item.insert("revision", 0);
+        item.insert("name", QString("file %1").arg(i, 3, 10, QChar('0')));
+        item.insert("size", 128*i);
+        return item;
+    };
+
+    // A few operations end up in the journal
+    for (int i = 9; i >= 0; i--)
+        QVERIFY(cache.putFile(makeFile(i)));
+    QVERIFY(cache.removeFile("file 004"));
+    QVERIFY(!cache.removeFile("missing"));
+    QVERIFY(cache.flush());
+
+    {
+        FilesCache reloaded;
+        reloaded.setDbChangeNumber(7);
+        reloaded.setCardCPZ(cpz);
+        QList<QVariantMap> files = reloaded.load();
+        QCOMPARE(files.size(), 9);
+        QVERIFY(reloaded.isInSync());
+        QCOMPARE(files.first().value("name").toString(), QString("file 000"));
+        QCOMPARE(files.last().value("name").toString(), QString("file 009"));
+        QVERIFY(!reloaded.contains("file 004"));
+    }
+
+    // Enough operations to fold the journal back into the cache file
+    for (int i = 10; i < 100; i++)
+        QVERIFY(cache.putFile(makeFile(i)));
+    for (int i = 0; i < 100; i += 2)
+        cache.removeFile(makeFile(i).value("name").toString());
+    QVariantMap updated = cache.file("file 051");
+    updated.insert("revision", 1);
+    QVERIFY(cache.putFile(updated));
+    cache.setDbChangeNumber(8);
+    QVERIFY(cache.flush());
+
+    {
+        FilesCache reloaded;
+        reloaded.setDbChangeNumber(8);
+        reloaded.setCardCPZ(cpz);
+        QList<QVariantMap> files = reloaded.load();
+        QCOMPARE(files.size(), 50);
+        for (int i = 1; i < files.size(); i++)
+            QVERIFY(files.at(i - 1).value("name").toString() < files.at(i).value("name").toString());
+        QCOMPARE(reloaded.file("file 051").value("revision").toInt(), 1);
+    }
+
+    {
+        FilesCache stale;
+        stale.setDbChangeNumber(9);
+        stale.setCardCPZ(cpz);
+        QVERIFY(stale.load().isEmpty());
+        QVERIFY(!stale.isInSync());
+    }
+
+    QVERIFY(cache.erase());
+}
@@ -49,6 +49,73 @@ void TestCredentialModel::oneCredentialRemoved()
     Q_ASSERT(l2.value("login").toString().compare("loginB") == 0);
 }
 
+void TestCredentialModel::deltaChanges()
+{
+    CredentialModel *model = createCredentialModelWithThreeLogins();
+
+    QVERIFY(!model->hasChanges());
+    QJsonObject delta = model->getJsonDelta();
+    QVERIFY(delta.value("credentials").toArray().isEmpty());
+    QVERIFY(delta.value("deleted").toArray().isEmpty());
+
+    QModelIndex serviceIdx = model->getServiceIndexByName("service.io");
+    QVERIFY(serviceIdx.isValid());
+    QCOMPARE(model->rowCount(serviceIdx), 3);
+
+    // Edit loginA, setting the same value again is not a change
+    QModelIndex loginAIdx;
+    for (int r = 0; r < model->rowCount(serviceIdx); r++)
+    {
+        const QModelIndex idx = model->index(r, 0, serviceIdx);
+        if (model->getLoginItemByIndex(idx)->name() == "loginA")
+            loginAIdx = idx;
+    }
+    QVERIFY(loginAIdx.isValid());
+    model->updateLoginItem(loginAIdx, CredentialModel::DescriptionRole, QString());
+    QVERIFY(!model->hasChanges());
+    model->updateLoginItem(loginAIdx, CredentialModel::DescriptionRole, QString("new description"));
+    QVERIFY(model->hasChanges());
+
+    // Add a credential, then one that is removed right away
+    model->addCredential("newservice.com", "newlogin", "password");
+    model->addCredential("other.com", "otherlogin", "password");
+    QVERIFY(model->removeCredential(model->index(0, 0, model->getServiceIndexByName("other.com"))));
+
+    // Remove the login with an empty name
+    serviceIdx = model->getServiceIndexByName("service.io");
+    QModelIndex emptyLoginIdx;
+    for (int r = 0; r < model->rowCount(serviceIdx); r++)
+    {
+        const QModelIndex idx = model->index(r, 0, serviceIdx);
+        if (model->getLoginItemByIndex(idx)->name().isEmpty())
+            emptyLoginIdx = idx;
+    }
+    QVERIFY(emptyLoginIdx.isValid());
+    model->removeCredential(emptyLoginIdx);
+
+    delta = model->getJsonDelta();
+    QJsonArray creds = delta.value("credentials").toArray();
+    QCOMPARE(creds.size(), 2);
+    QStringList logins;
+    for (const QJsonValue &cred : creds)
+        logins << cred.toObject().value("login").toString();
+    logins.sort();
+    QCOMPARE(logins, QStringList({"loginA", "newlogin"}));
+
+    QJsonArray deleted = delta.value("deleted").toArray();
+    QCOMPARE(deleted.size(), 1);
+    QCOMPARE(deleted.at(0).toArray(), QJsonArray({-71, 12}));
+
+    // The full list still carries every remaining login
+    QCOMPARE(model->getJsonChanges().size(), 3);
+
+    // Reloading from the device forgets the changes
+    model->load(QJsonDocument::fromJson(emptyLoginTestJson).array());
+    QVERIFY(!model->hasChanges());
+
+    delete model;
+}
+
 QModelIndex TestCredentialModel::findLoginIndex(QString loginName, QString serviceName, QAbstractItemModel *model)
 {
     bool found = false;
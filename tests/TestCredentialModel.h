@@ -20,6 +20,7 @@ public:
 private Q_SLOTS:
     void noChanges();
     void oneCredentialRemoved();
+    void deltaChanges();
 
 };
 
@@ -0,0 +1,90 @@
+#include <qtestcase.h>
+
+#include "TestDeviceMetrics.h"
+#include "../src/DeviceMetrics.h"
+#include <QJsonArray>
+
+
+TestDeviceMetrics::TestDeviceMetrics(QObject *parent) : QObject(parent)
+{
+}
+
+void TestDeviceMetrics::test_commandHistogram()
+{
+    DeviceMetrics metrics;
+    DeviceMetrics::CommandSample sample;
+    sample.packetsOut = 1;
+    sample.bytesOut = 64;
+    sample.packetsIn = 3;
+    sample.bytesIn = 192;
+
+    sample.latencyMs = 3;
+    metrics.commandDone(MPCmd::PING, sample);
+    sample.latencyMs = 40;
+    metrics.commandDone(MPCmd::PING, sample);
+    sample.latencyMs = 100000;
+    metrics.commandDone(MPCmd::PING, sample);
+
+    const QJsonObject ping = metrics.toJson()["commands"].toObject()["PING"].toObject();
+    QCOMPARE(ping["packets_out"].toInt(), 3);
+    QCOMPARE(ping["bytes_in"].toInt(), 576);
+
+    const QJsonObject latency = ping["latency_ms"].toObject();
+    QCOMPARE(latency["count"].toInt(), 3);
+    QCOMPARE(latency["max"].toInt(), 100000);
+
+    const QJsonArray buckets = latency["buckets"].toArray();
+    QCOMPARE(buckets.size(), DeviceMetrics::BUCKET_COUNT + 1);
+    QCOMPARE(buckets.first().toObject()["count"].toInt(), 1); // <= 5ms
+    QCOMPARE(buckets[3].toObject()["count"].toInt(), 1);      // <= 50ms
+    QCOMPARE(buckets.last().toObject()["le"].toString(), QString("+Inf"));
+    QCOMPARE(buckets.last().toObject()["count"].toInt(), 1);
+}
+
+void TestDeviceMetrics::test_timeouts()
+{
+    DeviceMetrics metrics;
+    DeviceMetrics::CommandSample sample;
+    sample.retries = 2;
+    sample.timedOut = true;
+    metrics.commandDone(MPCmd::GET_PASSWORD, sample);
+
+    const QJsonObject cmd = metrics.toJson()["commands"].toObject()["GET_PASSWORD"].toObject();
+    QCOMPARE(cmd["timeouts"].toInt(), 1);
+    QCOMPARE(cmd["retries"].toInt(), 2);
+    QCOMPARE(cmd["latency_ms"].toObject()["count"].toInt(), 0);
+
+    metrics.reset();
+    QVERIFY(metrics.toJson()["commands"].toObject().isEmpty());
+}
+
+void TestDeviceMetrics::test_jobs()
+{
+    const QString name = DeviceMetrics::jobsNameFromLog("Ask for password for service: example.com login: me");
+    QCOMPARE(name, QString("Ask for password for service"));
+    QCOMPARE(DeviceMetrics::jobsNameFromLog("Starting MMM mode"), QString("Starting MMM mode"));
+
+    DeviceMetrics metrics;
+    metrics.jobsDone(name, 120, true);
+    metrics.jobsDone(name, 80, false);
+
+    const QJsonObject job = metrics.toJson()["jobs"].toObject()[name].toObject();
+    QCOMPARE(job["failed"].toInt(), 1);
+    QCOMPARE(job["wall_ms"].toObject()["sum"].toInt(), 200);
+}
+
+void TestDeviceMetrics::test_prometheus()
+{
+    DeviceMetrics metrics;
+    DeviceMetrics::CommandSample sample;
+    sample.latencyMs = 7;
+    metrics.commandDone(MPCmd::PING, sample);
+    metrics.jobsDone("Quoted \"job\"", 10, true);
+
+    const QByteArray text = metrics.toPrometheus();
+    QVERIFY(text.contains("moolticute_command_latency_ms_bucket{command=\"PING\",le=\"5\"} 0\n"));
+    QVERIFY(text.contains("moolticute_command_latency_ms_bucket{command=\"PING\",le=\"10\"} 1\n"));
+    QVERIFY(text.contains("moolticute_command_latency_ms_bucket{command=\"PING\",le=\"+Inf\"} 1\n"));
+    QVERIFY(text.contains("moolticute_command_latency_ms_count{command=\"PING\"} 1\n"));
+    QVERIFY(text.contains("moolticute_jobs_failed_total{jobs=\"Quoted \\\"job\\\"\"} 0\n"));
+}
@@ -0,0 +1,20 @@
+#ifndef TESTDEVICEMETRICS_H
+#define TESTDEVICEMETRICS_H
+
+#include <QtTest/QtTest>
+
+class TestDeviceMetrics : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TestDeviceMetrics(QObject *parent = nullptr);
+
+private slots:
+    void test_commandHistogram();
+    void test_timeouts();
+    void test_jobs();
+    void test_prometheus();
+};
+
+#endif // TESTDEVICEMETRICS_H
@@ -0,0 +1,175 @@
+/******************************************************************************
+ **  Copyright (c) Raoul Hecky. All Rights Reserved.
+ **
+ **  Moolticute is free software; you can redistribute it and/or modify
+ **  it under the terms of the GNU General Public License as published by
+ **  the Free Software Foundation; either version 3 of the License, or
+ **  (at your option) any later version.
+ **
+ **  Moolticute is distributed in the hope that it will be useful,
+ **  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **  GNU General Public License for more details.
+ **
+ **  You should have received a copy of the GNU General Public License
+ **  along with Moolticute; if not, write to the Free Software
+ **  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ **
+ ******************************************************************************/
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "AppDaemon.h"
+#include "MPDevice_localSocket.h"
+#include "MPDeviceTrace.h"
+
+/*
+ * Replays a device trace recorded with "moolticuted --record-trace" and
+ * measures how long the daemon job/protocol stack takes to run a scenario.
+ *
+ * moolticute_benchmark --trace mmm-20200131-235959.trace --scenario mmm [--latency-scale 0]
+ */
+
+static std::atomic<quint64> allocationCount{0};
+
+void *operator new(std::size_t size)
+{
+    ++allocationCount;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+int main(int argc, char **argv)
+{
+    AppDaemon app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Moolticute trace replay benchmark");
+    parser.addHelpOption();
+
+    QCommandLineOption traceOption("trace", "Trace file to replay.", "file");
+    QCommandLineOption scenarioOption("scenario", "Scenario to run: mmm, export, import or fetch_file.", "name");
+    QCommandLineOption scaleOption("latency-scale", "Multiply recorded device latencies by this factor (default 1.0).", "factor", "1.0");
+    QCommandLineOption importOption("import-file", "Database file used by the import scenario.", "file");
+    QCommandLineOption serviceOption("service", "Data service used by the fetch_file scenario.", "service");
+    QCommandLineOption timeoutOption("timeout", "Give up after this many seconds (default 600).", "seconds", "600");
+    parser.addOption(traceOption);
+    parser.addOption(scenarioOption);
+    parser.addOption(scaleOption);
+    parser.addOption(importOption);
+    parser.addOption(serviceOption);
+    parser.addOption(timeoutOption);
+    parser.process(app);
+
+    const QString scenario = parser.value(scenarioOption);
+    const QStringList scenarios = {"mmm", "export", "import", "fetch_file"};
+    if (!parser.isSet(traceOption) || !scenarios.contains(scenario))
+    {
+        parser.showHelp(1);
+    }
+
+    QByteArray importData;
+    if (scenario == "import")
+    {
+        QFile importFile(parser.value(importOption));
+        if (!importFile.open(QIODevice::ReadOnly))
+        {
+            qCritical() << "Import scenario needs a readable --import-file";
+            return 1;
+        }
+        importData = importFile.readAll();
+    }
+
+    MPTrace trace;
+    if (!trace.load(parser.value(traceOption)))
+        return 1;
+
+    MPTraceReplayServer replay(trace, parser.value(scaleOption).toDouble());
+    MPDevice *device = nullptr;
+    bool scenarioStarted = false;
+    QElapsedTimer wallTimer;
+    quint64 startAllocations = 0;
+    int startPackets = 0;
+
+    auto report = [&](bool success, const QString &msg)
+    {
+        const qint64 ms = qMax<qint64>(1, wallTimer.elapsed());
+        const int packets = replay.packetsWritten() + replay.packetsRead() - startPackets;
+        QTextStream out(stdout);
+        out << "scenario:     " << scenario << '\n'
+            << "result:       " << (success ? "ok" : "failed") << " (" << msg << ")\n"
+            << "wall time:    " << ms << " ms\n"
+            << "packets:      " << packets << '\n'
+            << "packets/s:    " << (packets * 1000.0 / ms) << '\n'
+            << "allocations:  " << (allocationCount - startAllocations) << '\n'
+            << "mismatches:   " << replay.mismatches() << '\n';
+        out.flush();
+        app.exit(success ? 0 : 1);
+    };
+
+    auto runScenario = [&]()
+    {
+        scenarioStarted = true;
+        startAllocations = allocationCount;
+        startPackets = replay.packetsWritten() + replay.packetsRead();
+        wallTimer.start();
+
+        auto noProgress = [](const QVariantMap &) {};
+        if (scenario == "mmm")
+        {
+            device->startMemMgmtMode(false, noProgress,
+                                     [&](bool success, int, QString errMsg) { report(success, errMsg); });
+        }
+        else if (scenario == "export")
+        {
+            device->exportDatabase("none",
+                                   [&](bool success, QString errstr, QByteArray) { report(success, errstr); },
+                                   noProgress);
+        }
+        else if (scenario == "import")
+        {
+            device->importDatabase(importData, false,
+                                   [&](bool success, QString errstr) { report(success, errstr); },
+                                   noProgress);
+        }
+        else
+        {
+            device->getDataNode(parser.value(serviceOption), QString(), QString(),
+                                [&](bool success, QString errstr, QString, QByteArray) { report(success, errstr); },
+                                noProgress);
+        }
+    };
+
+    QObject::connect(MPDevice_localSocket::MonitorInstance(), &MPDeviceLocalMonitor::localDeviceAdded,
+                     [&](QString id)
+    {
+        device = new MPDevice_localSocket(&app, MPLocalDef{id});
+        QObject::connect(device, &MPDevice::statusChanged, [&](Common::MPStatus status)
+        {
+            if (status == Common::Unlocked && !scenarioStarted)
+                runScenario();
+        });
+    });
+
+    if (!replay.start())
+        return 1;
+
+    QTimer::singleShot(parser.value(timeoutOption).toInt() * 1000, [&]()
+    {
+        report(false, "timeout");
+    });
+
+    return app.exec();
+}
@@ -8,6 +8,7 @@
 #include "TestCredentialModelFilter.h"
 #include "TestDbExportsRegistry.h"
 #include "TestParseDomain.h"
+#include "TestDeviceMetrics.h"
 
 // Note: This is equivalent to QTEST_APPLESS_MAIN for multiple test classes.
 int main(int argc, char** argv)
@@ -50,6 +51,11 @@ int main(int argc, char** argv)
         runTest(&testParseDomain);
     }
 
+    {
+        TestDeviceMetrics testDeviceMetrics;
+        runTest(&testDeviceMetrics);
+    }
+
     return status;
 }
 
@@ -43,6 +43,8 @@ SOURCES += \
     ../src/DbBackupChangeNumbersComparator.cpp \
     ../src/ParseDomain.cpp \
     ../src/DeviceDetector.cpp \
+    ../src/MooltipassCmds.cpp \
+    ../src/DeviceMetrics.cpp \
     main.cpp \
     FilesCacheTests.cpp \
     UpdaterTests.cpp \
@@ -51,7 +53,8 @@ SOURCES += \
     TestCredentialModel.cpp \
     TestCredentialModelFilter.cpp \
     TestDbExportsRegistry.cpp \
-    TestParseDomain.cpp
+    TestParseDomain.cpp \
+    TestDeviceMetrics.cpp
 
 HEADERS += \
     ../src/SimpleCrypt/SimpleCrypt.h \
@@ -67,6 +70,8 @@ HEADERS += \
     ../src/DbBackupChangeNumbersComparator.h \
     ../src/ParseDomain.h \
     ../src/DeviceDetector.h \
+    ../src/MooltipassCmds.h \
+    ../src/DeviceMetrics.h \
     UpdaterTests.h \
     FilesCacheTests.h \
     DbBackupsTrackerTests.h \
@@ -74,6 +79,7 @@ HEADERS += \
     TestCredentialModel.h \
     TestCredentialModelFilter.h \
     TestDbExportsRegistry.h \
-    TestParseDomain.h
+    TestParseDomain.h \
+    TestDeviceMetrics.h
 
 DEFINES += SRCDIR=\\\"$$PWD/\\\"